@@ -18,6 +18,20 @@
 
 #include <RMG-Core/Core.hpp>
 
+#include <atomic>
+
+//
+// Local Defines
+//
+
+// samples of higher speed factors are
+// too fast to be listenable, so skip them
+#define AUDIO_MAX_SPEED_FACTOR 200
+
+// the speed factor is rounded to steps, so the stream
+// isn't recreated for every step while the speed ramps
+#define AUDIO_SPEED_FACTOR_STEP 5
+
 //
 // Local variables
 //
@@ -31,8 +45,17 @@ static AUDIO_INFO l_AudioInfo;
 static bool l_VolIsMuted              = false;
 static bool l_Paused                  = false;
 static bool l_FastForward             = false;
+static int  l_SpeedFactor             = 100;
+static bool l_Discard                 = false;
 static int  l_VolSDL                  = SDL_MIX_MAXVOLUME;
 static SDL_AudioStream* l_AudioStream = nullptr;
+static int l_AudioStreamFreq          = 0;
+
+// set on the GUI thread, used on the emulation thread
+static std::atomic<ptr_AudioCaptureCallback> l_AudioCaptureCallback = nullptr;
+
+static int l_VolumeSubscription       = 0;
+static int l_MutedSubscription        = 0;
 
 static uint8_t l_PrimaryBuffer[0x40000];
 static uint8_t l_OutputBuffer[0x40000];
@@ -49,6 +72,59 @@ static void load_settings(void)
     l_FastForward = false;
 }
 
+static void queue_audio(int length)
+{
+    SDL_memset(l_MixBuffer, 0, length);
+    SDL_MixAudioFormat(l_MixBuffer, l_OutputBuffer, l_HardwareSpec->format, length, l_VolSDL);
+    SDL_QueueAudio(l_SDLDevice, l_MixBuffer, length);
+}
+
+// (re)creates the stream which converts the samples to the
+// hardware format when its frequency has changed, the samples
+// are played faster or slower than the game frequency to match
+// the emulation speed, the samples which are left in the old
+// stream are queued first, so they aren't lost
+static void update_audio_stream(void)
+{
+    int speedFactor = (l_SpeedFactor + AUDIO_SPEED_FACTOR_STEP / 2) / AUDIO_SPEED_FACTOR_STEP * AUDIO_SPEED_FACTOR_STEP;
+    int freq = (int)((int64_t)l_GameFreq * speedFactor / 100);
+    int length;
+
+    if (l_AudioStream != nullptr && freq == l_AudioStreamFreq)
+    {
+        return;
+    }
+
+    if (l_AudioStream != nullptr)
+    {
+        SDL_AudioStreamFlush(l_AudioStream);
+        length = SDL_AudioStreamGet(l_AudioStream, l_OutputBuffer, sizeof(l_OutputBuffer));
+        if (length > 0)
+        {
+            queue_audio(length);
+        }
+        SDL_FreeAudioStream(l_AudioStream);
+    }
+
+    l_AudioStream = SDL_NewAudioStream(AUDIO_S16SYS, 2, freq, l_HardwareSpec->format, 2, l_HardwareSpec->freq);
+    l_AudioStreamFreq = freq;
+}
+
+static void on_setting_changed(SettingsID settingId)
+{
+    switch (settingId)
+    {
+    default:
+        break;
+    case SettingsID::Audio_Volume:
+        l_VolSDL = SDL_MIX_MAXVOLUME * CoreSettingsGetIntValue(SettingsID::Audio_Volume) / 100;
+        break;
+    case SettingsID::Audio_Muted:
+        l_VolIsMuted = CoreSettingsGetBoolValue(SettingsID::Audio_Muted);
+        break;
+    }
+}
+
 //
 // Basic Plugin Functions
 //
@@ -89,7 +165,13 @@ EXPORT m64p_error CALL PluginShutdown(void)
         l_HardwareSpec = NULL;
     }
 
+    // save pending settings before
+    // the plugin is unloaded
+    CoreSettingsFlush();
+
     SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    l_AudioCaptureCallback = nullptr;
+    l_Discard = false;
     l_PluginInit = false;
     return M64ERR_SUCCESS;
 }
@@ -139,12 +221,35 @@ EXPORT m64p_error CALL PluginConfig(void)
     UserInterface::MainDialog dialog(nullptr);
     dialog.exec();
 
-    // reload settings
-    load_settings();
+    // when a ROM is running, the changed settings
+    // are applied by on_setting_changed(), else
+    // they're loaded in RomOpen()
 
     return M64ERR_SUCCESS;
 }
 
+EXPORT m64p_error CALL PluginAudioCapture(ptr_AudioCaptureCallback callback)
+{
+    if (!l_PluginInit)
+    {
+        return M64ERR_NOT_INIT;
+    }
+
+    l_AudioCaptureCallback = callback;
+    return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL PluginAudioDiscard(int discard)
+{
+    if (!l_PluginInit)
+    {
+        return M64ERR_NOT_INIT;
+    }
+
+    l_Discard = discard != 0;
+    return M64ERR_SUCCESS;
+}
+
 //
 // Audio Plugin Functions
 //
@@ -168,8 +273,10 @@ EXPORT void CALL AiDacrateChanged( int SystemType )
             l_GameFreq = 48628316 / (*l_AudioInfo.AI_DACRATE_REG + 1);
             break;
     }
-    SDL_FreeAudioStream(l_AudioStream);
-    l_AudioStream = SDL_NewAudioStream(AUDIO_S16SYS, 2, l_GameFreq, l_HardwareSpec->format, 2, l_HardwareSpec->freq);
+
+    // the stream is recreated in AiLenChanged() when the
+    // frequency has changed, the core calls this after
+    // loading every state with the same rate as well
 }
 
 EXPORT void CALL AiLenChanged( void )
@@ -179,6 +286,16 @@ EXPORT void CALL AiLenChanged( void )
         return;
     }
 
+    // apply changed settings
+    CoreSettingsProcessEvents();
+
+    // the samples of speculative
+    // frames aren't used at all
+    if (l_Discard)
+    {
+        return;
+    }
+
     unsigned int LenReg = *l_AudioInfo.AI_LEN_REG;
     unsigned char *p = l_AudioInfo.RDRAM + (*l_AudioInfo.AI_DRAM_ADDR_REG & 0xFFFFFF);
 
@@ -195,6 +312,14 @@ EXPORT void CALL AiLenChanged( void )
         l_PrimaryBuffer[ i + 3 ] = p[ i + 1 ];
     }
 
+    // always pass the samples to the capture
+    // callback, even when muted or fast forwarding
+    ptr_AudioCaptureCallback captureCallback = l_AudioCaptureCallback;
+    if (captureCallback != nullptr)
+    {
+        captureCallback(l_PrimaryBuffer, LenReg, l_GameFreq);
+    }
+
     if (!l_VolIsMuted && !l_FastForward)
     {
         unsigned int audio_queued = SDL_GetQueuedAudioSize(l_SDLDevice);
@@ -214,15 +339,14 @@ EXPORT void CALL AiLenChanged( void )
 
         if (audio_queued < acceptable_latency)
         {
+            update_audio_stream();
             SDL_AudioStreamPut(l_AudioStream, l_PrimaryBuffer, LenReg);
         }
 
         int output_length = SDL_AudioStreamGet(l_AudioStream, l_OutputBuffer, sizeof(l_OutputBuffer));
         if (output_length > 0)
         {
-            SDL_memset(l_MixBuffer, 0, output_length);
-            SDL_MixAudioFormat(l_MixBuffer, l_OutputBuffer, l_HardwareSpec->format, output_length, l_VolSDL);
-            SDL_QueueAudio(l_SDLDevice, l_MixBuffer, output_length);
+            queue_audio(output_length);
         }
     }
 }
@@ -267,7 +391,14 @@ EXPORT int CALL RomOpen(void)
     l_HardwareSpec = obtained;
     SDL_PauseAudioDevice(l_SDLDevice, 0);
     l_Paused = 0;
-    l_AudioStream = SDL_NewAudioStream(AUDIO_S16SYS, 2, l_GameFreq, l_HardwareSpec->format, 2, l_HardwareSpec->freq);
+    update_audio_stream();
+
+    // the settings can change while the ROM is running,
+    // subscribe on the emulation thread so the changes
+    // are processed in AiLenChanged()
+    load_settings();
+    l_VolumeSubscription = CoreSettingsSubscribe(SettingsID::Audio_Volume, on_setting_changed);
+    l_MutedSubscription = CoreSettingsSubscribe(SettingsID::Audio_Muted, on_setting_changed);
 
     return 1;
 }
@@ -279,6 +410,11 @@ EXPORT void CALL RomClosed( void )
         return;
     }
 
+    CoreSettingsUnsubscribe(l_VolumeSubscription);
+    CoreSettingsUnsubscribe(l_MutedSubscription);
+    l_Discard = false;
+    l_SpeedFactor = 100;
+
     SDL_ClearQueuedAudio(l_SDLDevice);
     SDL_CloseAudioDevice(l_SDLDevice);
 
@@ -290,6 +426,7 @@ EXPORT void CALL RomClosed( void )
 
     SDL_FreeAudioStream(l_AudioStream);
     l_AudioStream = nullptr;
+    l_AudioStreamFreq = 0;
 }
 
 EXPORT void CALL ProcessAList(void)
@@ -298,14 +435,17 @@ EXPORT void CALL ProcessAList(void)
 
 EXPORT void CALL SetSpeedFactor(int percentage)
 {
-    if (percentage > 100)
-    {
-        l_FastForward = true;
-    }
-    else
+    if (!l_PluginInit || percentage == l_SpeedFactor)
     {
-        l_FastForward = false;
+        return;
     }
+
+    l_SpeedFactor = percentage;
+    l_FastForward = percentage > AUDIO_MAX_SPEED_FACTOR;
+
+    // the stream is recreated in AiLenChanged(), because
+    // with run-ahead the core's speed factor is set first
+    // and the real speed factor right afterwards
 }
 
 EXPORT void CALL VolumeMute(void)
@@ -0,0 +1,456 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <RMG-Core/Core.hpp>
+
+#include <filesystem>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <string>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif // _WIN32
+
+//
+// Local Defines
+//
+
+// exit codes, so scripts can tell
+// what kind of failure occurred
+#define EXIT_CODE_SUCCESS   0
+#define EXIT_CODE_USAGE     1
+#define EXIT_CODE_INIT      2
+#define EXIT_CODE_EMULATION 3
+
+//
+// Local Structures
+//
+
+struct l_Options
+{
+    std::string Rom;
+    std::string Disk;
+    std::string RspPlugin;
+    std::string GfxPlugin;
+    std::string AudioPlugin;
+    std::string InputPlugin;
+    int    Frames = 0;
+    double Seconds = 0;
+    bool   Unthrottled = false;
+    bool   Offscreen = false;
+    bool   NullAudio = false;
+    bool   Verbose = false;
+};
+
+//
+// Local Variables
+//
+
+static std::atomic<bool> l_EmulationFinished = false;
+static bool              l_EmulationResult = false;
+static std::string       l_EmulationError;
+
+//
+// Local Functions
+//
+
+static void print_usage(const char* name)
+{
+    std::cerr << "Usage: " << name << " [options] ROM" << std::endl
+              << std::endl
+              << "Runs the ROM without user interface and prints performance statistics." << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  --frames N      run N frames (vertical interrupts) since boot" << std::endl
+              << "  --seconds N     run for N seconds" << std::endl
+              << "  --disk FILE     64DD disk to run with the ROM" << std::endl
+              << "  --rsp FILE      RSP plugin to use instead of the configured one" << std::endl
+              << "  --gfx FILE      GFX plugin to use instead of the configured one" << std::endl
+              << "  --audio FILE    audio plugin to use instead of the configured one" << std::endl
+              << "  --input FILE    input plugin to use instead of the configured one" << std::endl
+              << "  --unthrottled   run without speed limiter and audio output" << std::endl
+              << "  --offscreen     render offscreen instead of in a window" << std::endl
+              << "  --null-audio    output audio to a dummy audio device" << std::endl
+              << "  --verbose       print core debug messages" << std::endl
+              << "  --help          print this help" << std::endl
+              << std::endl
+              << "Statistics:" << std::endl
+              << "  frames          vertical interrupts emulated during the measurement," << std::endl
+              << "                  not the frames which the game rendered" << std::endl
+              << "  wall_time       duration of the measurement in seconds" << std::endl
+              << "  cpu_time        CPU time used by the process in seconds" << std::endl
+              << "  vi_per_second   frames divided by wall_time" << std::endl
+              << std::endl
+              << "Exit codes:" << std::endl
+              << "  0  the requested frames or seconds have been emulated" << std::endl
+              << "  1  invalid arguments" << std::endl
+              << "  2  failed to initialize the core or the plugins" << std::endl
+              << "  3  emulation failed or stopped early, or the requested" << std::endl
+              << "     frames were already emulated before the measurement" << std::endl;
+}
+
+static bool parse_options(int argc, char** argv, l_Options& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1) < argc;
+
+        try
+        {
+            if (arg == "--frames" && hasValue)
+            {
+                options.Frames = std::stoi(argv[++i]);
+            }
+            else if (arg == "--seconds" && hasValue)
+            {
+                options.Seconds = std::stod(argv[++i]);
+            }
+            else if (arg == "--disk" && hasValue)
+            {
+                options.Disk = argv[++i];
+            }
+            else if (arg == "--rsp" && hasValue)
+            {
+                options.RspPlugin = argv[++i];
+            }
+            else if (arg == "--gfx" && hasValue)
+            {
+                options.GfxPlugin = argv[++i];
+            }
+            else if (arg == "--audio" && hasValue)
+            {
+                options.AudioPlugin = argv[++i];
+            }
+            else if (arg == "--input" && hasValue)
+            {
+                options.InputPlugin = argv[++i];
+            }
+            else if (arg == "--unthrottled")
+            {
+                options.Unthrottled = true;
+            }
+            else if (arg == "--offscreen")
+            {
+                options.Offscreen = true;
+            }
+            else if (arg == "--null-audio")
+            {
+                options.NullAudio = true;
+            }
+            else if (arg == "--verbose")
+            {
+                options.Verbose = true;
+            }
+            else if (!arg.starts_with("--") && options.Rom.empty())
+            {
+                options.Rom = arg;
+            }
+            else
+            {
+                std::cerr << "Invalid argument: " << arg << std::endl;
+                return false;
+            }
+        }
+        catch (...)
+        {
+            std::cerr << "Invalid value for " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (options.Rom.empty())
+    {
+        std::cerr << "No ROM given" << std::endl;
+        return false;
+    }
+
+    // exactly one of them is required
+    if ((options.Frames > 0) == (options.Seconds > 0))
+    {
+        std::cerr << "Either --frames or --seconds must be given" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// makes the path absolute, so it stays
+// valid after changing the working directory
+static bool resolve_file(std::string& file)
+{
+    std::error_code errorCode;
+
+    if (file.empty())
+    {
+        return true;
+    }
+
+    if (!std::filesystem::is_regular_file(file, errorCode))
+    {
+        std::cerr << "File doesn't exist: " << file << std::endl;
+        return false;
+    }
+
+    file = std::filesystem::absolute(file, errorCode).string();
+    return !errorCode;
+}
+
+static void set_environment_variable(const char* name, const char* value)
+{
+#ifdef _WIN32
+    _putenv_s(name, value);
+#else
+    setenv(name, value, 1);
+#endif // _WIN32
+}
+
+static void run_emulation(std::string rom, std::string disk)
+{
+    l_EmulationResult = CoreStartEmulation(rom, disk);
+    if (!l_EmulationResult)
+    {
+        // errors are stored per thread
+        l_EmulationError = CoreGetError();
+    }
+
+    l_EmulationFinished = true;
+}
+
+// waits until the condition is true,
+// or until emulation has finished
+template <typename T>
+static bool wait_for(T condition)
+{
+    while (!condition())
+    {
+        if (l_EmulationFinished)
+        {
+            return false;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return true;
+}
+
+// returns the CPU time used by the process in seconds,
+// std::clock() can't be used because it returns the
+// wall time on Windows
+static double get_cpu_time(void)
+{
+#ifdef _WIN32
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    ULARGE_INTEGER kernel, user;
+
+    if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+    {
+        return 0;
+    }
+
+    kernel.LowPart = kernelTime.dwLowDateTime;
+    kernel.HighPart = kernelTime.dwHighDateTime;
+    user.LowPart = userTime.dwLowDateTime;
+    user.HighPart = userTime.dwHighDateTime;
+
+    // in 100 nanosecond units
+    return (double)(kernel.QuadPart + user.QuadPart) / 10000000.0;
+#else
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+
+    return (double)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+           (double)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0;
+#endif // _WIN32
+}
+
+static void print_stats(uint64_t frames, double wallTime, double cpuTime)
+{
+    std::cout << std::fixed << std::setprecision(3)
+              << "frames=" << frames << std::endl
+              << "wall_time=" << wallTime << std::endl
+              << "cpu_time=" << cpuTime << std::endl
+              << "vi_per_second=" << (wallTime > 0 ? frames / wallTime : 0) << std::endl;
+}
+
+//
+// Exported Functions
+//
+
+int main(int argc, char** argv)
+{
+    l_Options options;
+    std::error_code errorCode;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::string(argv[i]) == "--help")
+        {
+            print_usage(argv[0]);
+            return EXIT_CODE_SUCCESS;
+        }
+    }
+
+    if (!parse_options(argc, argv, options))
+    {
+        print_usage(argv[0]);
+        return EXIT_CODE_USAGE;
+    }
+
+    if (!resolve_file(options.Rom) ||
+        !resolve_file(options.Disk) ||
+        !resolve_file(options.RspPlugin) ||
+        !resolve_file(options.GfxPlugin) ||
+        !resolve_file(options.AudioPlugin) ||
+        !resolve_file(options.InputPlugin))
+    {
+        return EXIT_CODE_USAGE;
+    }
+
+    // the core, plugins and data are
+    // found relative to the executable
+    std::filesystem::current_path(std::filesystem::absolute(argv[0], errorCode).parent_path(), errorCode);
+
+    // the core's default video extension
+    // and the audio plugin use SDL
+    if (options.Offscreen)
+    {
+        set_environment_variable("SDL_VIDEODRIVER", "offscreen");
+    }
+    if (options.NullAudio)
+    {
+        set_environment_variable("SDL_AUDIODRIVER", "dummy");
+    }
+
+    if (!CoreInit())
+    {
+        std::cerr << "CoreInit() Failed: " << CoreGetError() << std::endl;
+        return EXIT_CODE_INIT;
+    }
+
+    if (options.Verbose)
+    {
+        CoreSetupCallbacks([](CoreDebugMessageType type, std::string message)
+        {
+            std::cerr << message << std::endl;
+        },
+        [](CoreStateCallbackType type, int value)
+        {
+        });
+    }
+
+    // plugins given on the command line
+    // are used instead of the configured ones
+    if (options.RspPlugin.empty())
+    {
+        options.RspPlugin = CoreSettingsGetStringValue(SettingsID::Core_RSP_Plugin);
+    }
+    if (options.GfxPlugin.empty())
+    {
+        options.GfxPlugin = CoreSettingsGetStringValue(SettingsID::Core_GFX_Plugin);
+    }
+    if (options.AudioPlugin.empty())
+    {
+        options.AudioPlugin = CoreSettingsGetStringValue(SettingsID::Core_AUDIO_Plugin);
+    }
+    if (options.InputPlugin.empty())
+    {
+        options.InputPlugin = CoreSettingsGetStringValue(SettingsID::Core_INPUT_Plugin);
+    }
+
+    if (!CoreApplyPluginFiles(options.RspPlugin, options.GfxPlugin, options.AudioPlugin, options.InputPlugin) ||
+        !CoreArePluginsReady())
+    {
+        std::cerr << "Failed to load plugins: " << CoreGetError() << std::endl;
+        CoreShutdown();
+        return EXIT_CODE_INIT;
+    }
+
+    CoreSetUnthrottled(options.Unthrottled);
+
+    std::thread emulationThread(run_emulation, options.Rom, options.Disk);
+
+    bool ret = wait_for(CoreIsEmulationRunning);
+
+    // pause first, so exactly the requested
+    // amount of frames is emulated since boot,
+    // the pause isn't part of the measurement
+    if (ret && options.Frames > 0)
+    {
+        ret = CorePauseEmulation() && wait_for(CoreIsEmulationPaused);
+    }
+
+    auto wallStart = std::chrono::steady_clock::now();
+    double cpuStart = get_cpu_time();
+    uint64_t framesStart = CoreGetFrameCount();
+
+    if (ret && options.Frames > 0)
+    {
+        // nothing would be measured when the frames
+        // were already emulated before pausing
+        if (framesStart >= (uint64_t)options.Frames)
+        {
+            CoreSetError("the requested frames were already emulated before the measurement (" +
+                         std::to_string(framesStart) + " >= " + std::to_string(options.Frames) + ")");
+            ret = false;
+        }
+        else
+        {
+            ret = CoreRunFrames(options.Frames - (int)framesStart);
+        }
+    }
+    else if (ret)
+    {
+        auto wallEnd = wallStart + std::chrono::duration<double>(options.Seconds);
+        ret = wait_for([wallEnd]()
+        {
+            return std::chrono::steady_clock::now() >= wallEnd;
+        });
+    }
+
+    double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    double cpuTime = get_cpu_time() - cpuStart;
+    // only the frames emulated during the
+    // measurement are used for the statistics
+    uint64_t frames = CoreGetFrameCount() - framesStart;
+
+    if (!l_EmulationFinished)
+    {
+        CoreStopEmulation();
+    }
+
+    emulationThread.join();
+
+    if (!l_EmulationResult)
+    {
+        std::cerr << "CoreStartEmulation() Failed: " << l_EmulationError << std::endl;
+        ret = false;
+    }
+    else if (!ret)
+    {
+        std::cerr << "Emulation stopped early: " << CoreGetError() << std::endl;
+    }
+
+    print_stats(frames, wallTime, cpuTime);
+
+    CoreShutdown();
+    return ret ? EXIT_CODE_SUCCESS : EXIT_CODE_EMULATION;
+}
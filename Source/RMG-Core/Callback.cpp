@@ -10,12 +10,21 @@
 #define CORE_INTERNAL
 #include "Core.hpp"
 
+#include <atomic>
+
 //
 // Local Variables
 //
 
 static bool l_SetupCallbacks = false;
 static std::function<void(enum CoreDebugMessageType, std::string)> l_DebugCallbackFunc;
+static std::function<void(enum CoreStateCallbackType, int)> l_StateCallbackFunc;
+
+// latest value of every core state, the core reports
+// changes through CoreStateCallback, so querying the
+// state is an atomic load instead of a core command
+static std::atomic<int>  l_CoreStates[(int)CoreStateCallbackType::SaveStateComplete + 1];
+static std::atomic<bool> l_CoreStatesValid[(int)CoreStateCallbackType::SaveStateComplete + 1];
 
 //
 // Internal Functions
@@ -33,16 +42,59 @@ void CoreDebugCallback(void* context, int level, const char* message)
 
 void CoreStateCallback(void* context, m64p_core_param param, int value)
 {
-    // TODO
+    if (param >= M64CORE_EMU_STATE && param <= M64CORE_STATE_SAVECOMPLETE)
+    {
+        l_CoreStates[param] = value;
+        l_CoreStatesValid[param] = true;
+    }
+
+    if (!l_SetupCallbacks)
+    {
+        return;
+    }
+
+    l_StateCallbackFunc((CoreStateCallbackType)param, value);
+}
+
+void CoreFrameCallback(unsigned int frameIndex)
+{
+    CoreSpeedFactorOnFrame();
+
+    // speculative run-ahead frames
+    // aren't captured for rewinding
+    if (!CoreRunAheadOnFrame())
+    {
+        return;
+    }
+
+    CoreFrameStepOnFrame();
+    CoreSaveStateOnFrame();
+    CoreRewindOnFrame();
+}
+
+bool CoreGetCachedState(CoreStateCallbackType type, int& value)
+{
+    int index = (int)type;
+
+    if (index < 1 || index > (int)CoreStateCallbackType::SaveStateComplete ||
+        !l_CoreStatesValid[index])
+    {
+        return false;
+    }
+
+    value = l_CoreStates[index];
+    return true;
 }
 
 //
 // Exported Functions
 //
 
-bool CoreSetupCallbacks(std::function<void(enum CoreDebugMessageType, std::string)> debugCallbackFunc)
+bool CoreSetupCallbacks(std::function<void(enum CoreDebugMessageType, std::string)> debugCallbackFunc,
+                        std::function<void(enum CoreStateCallbackType, int)> stateCallbackFunc)
 {
     l_DebugCallbackFunc = debugCallbackFunc;
+    l_StateCallbackFunc = stateCallbackFunc;
     l_SetupCallbacks = true;
     return true;
 }
@@ -20,6 +20,7 @@
 
 void CoreDebugCallback(void* context, int level, const char* message);
 void CoreStateCallback(void* context, m64p_core_param param, int value);
+void CoreFrameCallback(unsigned int frameIndex);
 
 #endif // CORE_INTERNAL
 
@@ -32,6 +33,30 @@ enum class CoreDebugMessageType
     Verbose = 5
 };
 
-bool CoreSetupCallbacks(std::function<void(enum CoreDebugMessageType, std::string)> debugCallbackFunc);
+// mirrors m64p_core_param
+enum class CoreStateCallbackType
+{
+    EmulationState = 1,
+    VideoMode,
+    SaveStateSlot,
+    SpeedFactor,
+    SpeedLimiter,
+    VideoSize,
+    AudioVolume,
+    AudioMute,
+    InputGameshark,
+    LoadStateComplete,
+    SaveStateComplete
+};
+
+#ifdef CORE_INTERNAL
+// retrieves the latest value of the core state
+// reported by CoreStateCallback, returns false
+// when the core hasn't reported it yet
+bool CoreGetCachedState(CoreStateCallbackType type, int& value);
+#endif // CORE_INTERNAL
+
+bool CoreSetupCallbacks(std::function<void(enum CoreDebugMessageType, std::string)> debugCallbackFunc,
+                        std::function<void(enum CoreStateCallbackType, int)> stateCallbackFunc);
 
 #endif // CORE_CALLBACK_HPP
@@ -15,6 +15,16 @@
 #include "m64p/api/version.h"
 #include <filesystem>
 
+//
+// Local Defines
+//
+
+#ifdef _WIN32
+#define CORE_LIB_FILE "Core/mupen64plus" OSAL_DYNLIB_LIB_EXT_STR
+#else
+#define CORE_LIB_FILE "Core/libmupen64plus" OSAL_DYNLIB_LIB_EXT_STR
+#endif // _WIN32
+
 //
 // Local Variables
 //
@@ -27,6 +37,13 @@ static osal_dynlib_lib_handle l_CoreLibHandle;
 
 std::string find_core_lib(void)
 {
+    // try the file we install first, walking
+    // the directory is slow on network drives
+    if (std::filesystem::is_regular_file(CORE_LIB_FILE))
+    {
+        return CORE_LIB_FILE;
+    }
+
     for (const auto& entry : std::filesystem::recursive_directory_iterator("Core"))
     {
         std::string path = entry.path().string();
@@ -77,7 +94,10 @@ bool CoreInit(void)
     m64p_error  m64p_ret;
     bool ret = false;
 
+    CoreTrace("CoreInit");
+
     core_file = find_core_lib();
+    CoreTrace("CoreInit: found core library");
     if (core_file.empty())
     {
         error = "no core lib found";
@@ -110,6 +130,8 @@ bool CoreInit(void)
         return false;
     }
 
+    CoreTrace("CoreInit: hooked core library");
+
     m64p_ret = m64p::Core.Startup(FRONTEND_API_VERSION, "Config", "Data", nullptr, CoreDebugCallback, nullptr, CoreStateCallback);
     if (m64p_ret != M64ERR_SUCCESS)
     {
@@ -119,6 +141,12 @@ bool CoreInit(void)
         return false;
     }
 
+    CoreTrace("CoreInit: started core");
+
+    // this copy started the core,
+    // so it writes the config file
+    CoreSettingsSetFileOwner();
+
     if (!config_override_user_dirs())
     {
         return false;
@@ -130,12 +158,7 @@ bool CoreInit(void)
         return false;
     }
 
-    ret = CoreApplyPluginSettings();
-    if (!ret)
-    {
-        return false;
-    }
-
+    CoreTrace("CoreInit: setup default settings");
     return true;
 }
 
@@ -165,6 +188,14 @@ bool CoreInit(m64p_dynlib_handle handle)
 
 void CoreShutdown(void)
 {
+    // make sure pending settings are
+    // saved before the core is unloaded
+    CoreSettingsFlush();
+
+    // make sure pending save states
+    // are written before exiting
+    CoreSaveStateFlush();
+
     CorePluginsShutdown();
 
     osal_dynlib_close(l_CoreLibHandle);
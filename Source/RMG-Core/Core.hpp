@@ -19,7 +19,13 @@
 #include "RomHeader.hpp"
 #include "Callback.hpp"
 #include "Plugins.hpp"
+#include "RunAhead.hpp"
+#include "FrameStep.hpp"
+#include "Rewind.hpp"
+#include "RomCache.hpp"
+#include "RomInspect.hpp"
 #include "Error.hpp"
+#include "Trace.hpp"
 #include "Video.hpp"
 #include "Key.hpp"
 #ifdef CORE_PLUGIN
@@ -32,7 +38,8 @@
 #endif // CORE_PLUGIN
 
 
-// initializes the core library,
+// initializes the core library, the plugins
+// have to be loaded with CoreApplyPluginSettings(),
 // returns false when failed
 bool CoreInit(void);
 
@@ -7,11 +7,19 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
+#define CORE_INTERNAL
 #include "Emulation.hpp"
 #include "m64p/Api.hpp"
+#include "Callback.hpp"
 #include "Plugins.hpp"
+#include "RunAhead.hpp"
+#include "Rewind.hpp"
+#include "SpeedLimiter.hpp"
+#include "FrameStep.hpp"
+#include "SaveState.hpp"
 #include "Error.hpp"
 #include "Rom.hpp"
+#include "Settings/Settings.hpp"
 
 //
 // Local Functions
@@ -21,6 +29,13 @@ static bool get_emulation_state(m64p_emu_state* state)
 {
     std::string error;
     m64p_error ret;
+    int value;
+
+    if (CoreGetCachedState(CoreStateCallbackType::EmulationState, value))
+    {
+        *state = (m64p_emu_state)value;
+        return true;
+    }
 
     ret = m64p::Core.DoCommand(M64CMD_CORE_STATE_QUERY, M64CORE_EMU_STATE, state);
     if (ret != M64ERR_SUCCESS)
@@ -62,6 +77,22 @@ bool CoreStartEmulation(std::string n64rom, std::string n64ddrom)
         return false;
     }
 
+    ret = m64p::Core.DoCommand(M64CMD_SET_FRAME_CALLBACK, 0, (void*)CoreFrameCallback);
+    if (ret != M64ERR_SUCCESS)
+    {
+        error = "CoreStartEmulation m64p::Core.DoCommand(M64CMD_SET_FRAME_CALLBACK) Failed: ";
+        error += m64p::Core.ErrorMessage(ret);
+        CoreSetError(error);
+        CoreDetachPlugins();
+        CoreCloseRom();
+        return false;
+    }
+
+    CoreSpeedFactorStart();
+    CoreFrameStepStart();
+    CoreRewindStart();
+    CoreRunAheadStart();
+
     ret = m64p::Core.DoCommand(M64CMD_EXECUTE, 0, nullptr);
     if (ret != M64ERR_SUCCESS)
     {
@@ -70,9 +101,21 @@ bool CoreStartEmulation(std::string n64rom, std::string n64ddrom)
         CoreSetError(error);
     }
 
+    // make sure the cached emulation state
+    // is updated, even when execution failed
+    CoreStateCallback(nullptr, M64CORE_EMU_STATE, M64EMU_STOPPED);
+
+    CoreFrameStepStop();
+    CoreRunAheadStop();
+    CoreRewindStop();
+    CoreSaveStateCancel();
     CoreDetachPlugins();
     CoreCloseRom();
 
+    // the core and plugins might've
+    // changed settings during emulation
+    CoreSettingsInvalidate();
+
     // restore plugin settings
     CoreApplyPluginSettings();
 
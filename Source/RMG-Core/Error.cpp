@@ -9,11 +9,24 @@
  */
 #include "Error.hpp"
 
+//
+// Local Structures
+//
+
+// the message is only built when it's retrieved,
+// Prefix and Detail are used when Message is empty
+struct l_CoreError
+{
+    std::string Message;
+    const char* Prefix = nullptr;
+    const char* Detail = nullptr;
+};
+
 //
 // Local Variables
 //
 
-static std::string l_ErrorMessage;
+static thread_local l_CoreError l_Error;
 
 //
 // Exported Functions
@@ -21,10 +34,41 @@ static std::string l_ErrorMessage;
 
 void CoreSetError(std::string error)
 {
-    l_ErrorMessage = error;
+    l_Error.Message = std::move(error);
+    l_Error.Prefix  = nullptr;
+    l_Error.Detail  = nullptr;
+}
+
+void CoreSetError(const char* error)
+{
+    CoreSetError(error, nullptr);
+}
+
+void CoreSetError(const char* prefix, const char* detail)
+{
+    // keeps the capacity of the message around
+    l_Error.Message.clear();
+    l_Error.Prefix = prefix;
+    l_Error.Detail = detail;
 }
 
 std::string CoreGetError(void)
 {
-    return l_ErrorMessage;
+    if (!l_Error.Message.empty())
+    {
+        return l_Error.Message;
+    }
+
+    std::string error;
+
+    if (l_Error.Prefix != nullptr)
+    {
+        error = l_Error.Prefix;
+    }
+    if (l_Error.Detail != nullptr)
+    {
+        error += l_Error.Detail;
+    }
+
+    return error;
 }
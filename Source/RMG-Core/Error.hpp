@@ -12,10 +12,24 @@
 
 #include <string>
 
+// error messages are stored per thread,
+// so CoreGetError() retrieves the last error
+// set by the calling thread
+
 // sets error message
 void CoreSetError(std::string error);
 
+// sets error message without allocating,
+// error must be a string literal
+void CoreSetError(const char* error);
+
+// sets error message consisting of prefix and detail
+// without allocating, both must outlive the next
+// CoreSetError() call on this thread (i.e string literals
+// or messages returned by the core)
+void CoreSetError(const char* prefix, const char* detail);
+
 // retrieves error message
 std::string CoreGetError(void);
 
-#endif // CORE_ERROR_HPP
\ No newline at end of file
+#endif // CORE_ERROR_HPP
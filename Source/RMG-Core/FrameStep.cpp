@@ -0,0 +1,279 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#define CORE_INTERNAL
+#include "FrameStep.hpp"
+#include "SpeedLimiter.hpp"
+#include "Emulation.hpp"
+#include "Plugins.hpp"
+#include "Error.hpp"
+#include "Key.hpp"
+
+#include "m64p/Api.hpp"
+
+#include <condition_variable>
+#include <atomic>
+#include <mutex>
+#include <map>
+#include <vector>
+
+//
+// Local Structures
+//
+
+struct l_KeyEvent
+{
+    int  Key;
+    int  Mod;
+    bool Pressed;
+};
+
+//
+// Local Variables
+//
+
+static std::mutex                           l_FrameStepMutex;
+static std::condition_variable              l_FrameStepCondition;
+static int                                  l_FramesRemaining = 0;
+static bool                                 l_Advancing = false;
+static bool                                 l_Stopped = true;
+static std::multimap<uint64_t, l_KeyEvent>  l_KeyEvents;
+
+static std::atomic<uint64_t> l_FrameCount = 0;
+static std::atomic<bool>     l_Unthrottled = false;
+
+// only used on the emulation thread
+static bool l_FirstFrame = false;
+static bool l_UnthrottledApplied = false;
+static bool l_SpeedLimiterEnabled = true;
+
+//
+// Local Functions
+//
+
+// applies unthrottled mode when it has changed, the
+// speed limiter state from before is restored afterwards,
+// even when it was left enabled in a previous run
+static void apply_unthrottled(bool force)
+{
+    bool enabled = l_Unthrottled;
+
+    if (!force && enabled == l_UnthrottledApplied)
+    {
+        return;
+    }
+
+    if (enabled && !l_UnthrottledApplied)
+    {
+        l_SpeedLimiterEnabled = CoreIsSpeedLimiterEnabled();
+    }
+
+    if (enabled || l_UnthrottledApplied)
+    {
+        CoreSetSpeedLimiterState(enabled ? false : l_SpeedLimiterEnabled);
+        CorePluginsSetAudioDiscard(enabled);
+    }
+
+    l_UnthrottledApplied = enabled;
+}
+
+//
+// Internal Functions
+//
+
+void CoreFrameStepStart(void)
+{
+    std::lock_guard<std::mutex> lock(l_FrameStepMutex);
+
+    l_FrameCount = 0;
+    l_FramesRemaining = 0;
+    l_Advancing = false;
+    l_Stopped = false;
+    l_FirstFrame = true;
+}
+
+void CoreFrameStepStop(void)
+{
+    std::lock_guard<std::mutex> lock(l_FrameStepMutex);
+
+    l_Stopped = true;
+    l_KeyEvents.clear();
+    l_FrameStepCondition.notify_all();
+}
+
+void CoreFrameStepOnFrame(void)
+{
+    std::vector<l_KeyEvent> events;
+    uint64_t frame = ++l_FrameCount;
+    bool finished = false;
+    bool pause = false;
+
+    apply_unthrottled(l_FirstFrame);
+    l_FirstFrame = false;
+
+    {
+        std::lock_guard<std::mutex> lock(l_FrameStepMutex);
+
+        auto end = l_KeyEvents.upper_bound(frame);
+        for (auto iter = l_KeyEvents.begin(); iter != end; iter++)
+        {
+            events.push_back(iter->second);
+        }
+        l_KeyEvents.erase(l_KeyEvents.begin(), end);
+
+        if (l_FramesRemaining > 0 && --l_FramesRemaining == 0)
+        {
+            // M64CMD_ADVANCE_FRAME pauses by itself
+            pause = !l_Advancing;
+            l_Advancing = false;
+            finished = true;
+        }
+    }
+
+    for (const l_KeyEvent& event : events)
+    {
+        if (event.Pressed)
+        {
+            CoreSetKeyDown(event.Key, event.Mod);
+        }
+        else
+        {
+            CoreSetKeyUp(event.Key, event.Mod);
+        }
+    }
+
+    // pausing from the frame callback makes
+    // the core pause right after this frame
+    if (pause)
+    {
+        m64p::Core.DoCommand(M64CMD_PAUSE, 0, nullptr);
+    }
+
+    if (finished)
+    {
+        l_FrameStepCondition.notify_all();
+    }
+}
+
+bool CoreFrameStepIsVideoDisabled(void)
+{
+    return l_Unthrottled;
+}
+
+//
+// Exported Functions
+//
+
+bool CoreRunFrames(int frames)
+{
+    std::string error;
+    m64p_error ret = M64ERR_SUCCESS;
+    bool paused;
+    bool advance;
+
+    if (frames <= 0)
+    {
+        CoreSetError("CoreRunFrames Failed: frames must be greater than 0!");
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(l_FrameStepMutex);
+
+    if (l_Stopped)
+    {
+        CoreSetError("CoreRunFrames Failed: cannot run frames when emulation isn't running!");
+        return false;
+    }
+
+    if (l_FramesRemaining > 0)
+    {
+        CoreSetError("CoreRunFrames Failed: cannot run frames when frames are already being run!");
+        return false;
+    }
+
+    // a single frame can be emulated with M64CMD_ADVANCE_FRAME,
+    // more frames are emulated by resuming and pausing from
+    // the frame callback, because the core checks whether it's
+    // still paused only every 10ms
+    paused = CoreIsEmulationPaused();
+    advance = paused && frames == 1;
+    l_FramesRemaining = frames;
+    l_Advancing = advance;
+    lock.unlock();
+
+    if (paused)
+    {
+        ret = m64p::Core.DoCommand(advance ? M64CMD_ADVANCE_FRAME : M64CMD_RESUME, 0, nullptr);
+    }
+
+    lock.lock();
+
+    if (ret != M64ERR_SUCCESS)
+    {
+        l_FramesRemaining = 0;
+        l_Advancing = false;
+        error = "CoreRunFrames m64p::Core.DoCommand() Failed: ";
+        error += m64p::Core.ErrorMessage(ret);
+        CoreSetError(error);
+        return false;
+    }
+
+    l_FrameStepCondition.wait(lock, []
+    {
+        return l_FramesRemaining == 0 || l_Stopped;
+    });
+
+    if (l_FramesRemaining > 0)
+    {
+        l_FramesRemaining = 0;
+        l_Advancing = false;
+        CoreSetError("CoreRunFrames Failed: emulation stopped before the frames were emulated!");
+        return false;
+    }
+
+    return true;
+}
+
+bool CoreStepFrame(void)
+{
+    return CoreRunFrames(1);
+}
+
+uint64_t CoreGetFrameCount(void)
+{
+    return l_FrameCount;
+}
+
+bool CoreQueueKeyEvent(uint64_t frame, int key, int mod, bool pressed)
+{
+    std::lock_guard<std::mutex> lock(l_FrameStepMutex);
+
+    if (!l_Stopped && l_FrameCount > 0 && frame <= l_FrameCount)
+    {
+        CoreSetError("CoreQueueKeyEvent Failed: cannot queue key event for a frame which has already been emulated!");
+        return false;
+    }
+
+    l_KeyEvents.insert({frame, {key, mod, pressed}});
+    return true;
+}
+
+bool CoreSetUnthrottled(bool enabled)
+{
+    // applied from the frame callback,
+    // because the core only accepts state
+    // changes while emulation is running
+    l_Unthrottled = enabled;
+    return true;
+}
+
+bool CoreIsUnthrottled(void)
+{
+    return l_Unthrottled;
+}
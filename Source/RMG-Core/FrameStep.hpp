@@ -0,0 +1,64 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_FRAMESTEP_HPP
+#define CORE_FRAMESTEP_HPP
+
+#include <cstdint>
+
+// internal frame stepping functions
+#ifdef CORE_INTERNAL
+
+// resets the frame counter,
+// called before emulation starts
+void CoreFrameStepStart(void);
+
+// wakes up waiting callers and clears
+// queued input, called after emulation stopped
+void CoreFrameStepStop(void);
+
+// counts the frame, sends queued input and pauses
+// emulation when the requested frames have been
+// emulated, called from the frame callback
+void CoreFrameStepOnFrame(void);
+
+// returns whether video output is skipped in
+// unthrottled mode, see CoreSetUnthrottled()
+bool CoreFrameStepIsVideoDisabled(void);
+
+#endif // CORE_INTERNAL
+
+// runs the given amount of frames and pauses emulation
+// afterwards, blocks until the frames have been emulated,
+// must not be called from the emulation thread
+bool CoreRunFrames(int frames);
+
+// runs a single frame, see CoreRunFrames()
+bool CoreStepFrame(void);
+
+// returns the amount of frames
+// emulated since emulation started
+uint64_t CoreGetFrameCount(void);
+
+// queues a key press or release (see CoreSetKeyDown())
+// which is sent to the input plugin once the given amount
+// of frames has been emulated, so scripted input is
+// applied at the same frame every run
+bool CoreQueueKeyEvent(uint64_t frame, int key, int mod, bool pressed);
+
+// sets whether emulation runs unthrottled, which disables
+// the speed limiter, audio output and video output, video
+// output is only disabled when CoreSetupVidExt() has been
+// called, run-ahead should be disabled when using it
+bool CoreSetUnthrottled(bool enabled);
+
+// returns whether emulation runs unthrottled
+bool CoreIsUnthrottled(void);
+
+#endif // CORE_FRAMESTEP_HPP
@@ -7,11 +7,13 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
+#define CORE_INTERNAL
 #include "Plugins.hpp"
 #include "Error.hpp"
 #include "Emulation.hpp"
 #include "RomSettings.hpp"
 #include "Settings/Settings.hpp"
+#include "Trace.hpp"
 
 #include "m64p/PluginApi.hpp"
 #include "osal/osal_dynlib.hpp"
@@ -19,277 +21,485 @@
 #include "m64p/PluginApi.cpp"
 #include "m64p/Api.hpp"
 
+#include <charconv>
 #include <filesystem>
+#include <fstream>
+#include <memory>
 #include <string>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+//
+// Local Defines
+//
+
+#define PLUGIN_CACHE_FILE_NAME "RMG-PluginCache.cache"
+#define PLUGIN_CACHE_FIELDS    9
+
+//
+// Local Structures
+//
+
+struct l_PluginCacheEntry
+{
+    uintmax_t  FileSize;
+    int64_t    FileTime;
+    CorePlugin Plugin;
+};
 
 //
 // Local Variables
 //
 
-static m64p::PluginApi l_Plugins[(int)CorePluginType::Input];
-static std::string     l_PluginFiles[(int)CorePluginType::Input];
+// every plugin which has been used is kept loaded
+// and started in the pool, applying plugin settings
+// only switches which plugins are used
+static std::unordered_map<std::string, std::unique_ptr<m64p::PluginApi>> l_PluginPool;
+static m64p::PluginApi* l_Plugins[(int)CorePluginType::Input] = { nullptr };
+static std::string      l_PluginFiles[(int)CorePluginType::Input];
+static m64p::PluginApi  l_EmptyPlugin;
+// the plugins can be loaded on a different
+// thread than the one using them
+static std::recursive_mutex l_PluginsMutex;
+
+static std::unordered_map<std::string, l_PluginCacheEntry> l_PluginCache;
+static bool                                                l_PluginCacheLoaded = false;
+static std::mutex                                          l_PluginCacheMutex;
 
 //
 // Local Functions
 //
 
+// retrieves the plugin of the given type, the plugin
+// is kept in the pool until CorePluginsShutdown()
 m64p::PluginApi* get_plugin(CorePluginType type)
 {
-    return &l_Plugins[(int)type - 1];
+    std::lock_guard<std::recursive_mutex> lock(l_PluginsMutex);
+    m64p::PluginApi* plugin = l_Plugins[(int)type - 1];
+    return plugin != nullptr ? plugin : &l_EmptyPlugin;
 }
 
-CorePluginType get_plugin_type(m64p::PluginApi* plugin)
+// retrieves started plugin from the pool,
+// the plugin is loaded when it isn't in the pool yet
+static m64p::PluginApi* get_pooled_plugin(std::string file, std::string functionName)
 {
-    m64p_error ret;
-    m64p_plugin_type m64p_type = M64PLUGIN_NULL;
+    std::string            error;
+    osal_dynlib_lib_handle handle;
+    m64p_error             ret;
+
+    auto iter = l_PluginPool.find(file);
+    if (iter != l_PluginPool.end())
+    {
+        return iter->second.get();
+    }
 
-    ret = plugin->GetVersion(&m64p_type, nullptr, nullptr, nullptr, nullptr);
+    std::unique_ptr<m64p::PluginApi> plugin = std::make_unique<m64p::PluginApi>();
+
+    // attempt to open the library
+    handle = osal_dynlib_open(file.c_str());
+    if (handle == nullptr)
+    {
+        error = functionName + " osal_dynlib_open Failed: ";
+        error += osal_dynlib_strerror();
+        CoreSetError(error);
+        return nullptr;
+    }
+
+    // attempt to hook the library
+    if (!plugin->Hook(handle))
+    {
+        error = functionName + " m64p::PluginApi.Hook() Failed: ";
+        error += plugin->GetLastError();
+        CoreSetError(error);
+        osal_dynlib_close(handle);
+        return nullptr;
+    }
+
+    // attempt to start plugin
+    ret = plugin->Startup(m64p::Core.GetHandle(), nullptr, nullptr);
     if (ret != M64ERR_SUCCESS)
     {
-        return CorePluginType::Invalid;
+        error = functionName + " m64p::PluginApi.Startup() Failed: ";
+        error += m64p::Core.ErrorMessage(ret);
+        CoreSetError(error);
+        plugin->Unhook();
+        osal_dynlib_close(handle);
+        return nullptr;
     }
 
-    if (m64p_type < 1 || m64p_type > 4)
+    CoreTrace(functionName + ": started " + file);
+
+    // plugins set their default
+    // settings during startup
+    CoreSettingsInvalidate();
+
+    return l_PluginPool.emplace(file, std::move(plugin)).first->second.get();
+}
+
+// switches the used plugins to the given files,
+// empty or invalid files are skipped, the settings
+// are locked because plugins use the config during
+// startup, which can happen on the loader thread
+static bool apply_plugin_files(const std::string files[], std::string functionName)
+{
+    std::lock_guard<std::recursive_mutex> settingsLock(CoreSettingsGetMutex());
+    m64p::PluginApi* plugin;
+
+    for (int i = 0; i < 4; i++)
     {
-        return CorePluginType::Invalid;
+        if (files[i].empty() ||
+            !std::filesystem::is_regular_file(files[i]))
+        { // skip invalid setting value
+            continue;
+        }
+
+        if (files[i] == l_PluginFiles[i])
+        {
+            continue;
+        }
+
+        plugin = get_pooled_plugin(files[i], functionName);
+        if (plugin == nullptr)
+        {
+            return false;
+        }
+
+        l_Plugins[i] = plugin;
+        l_PluginFiles[i] = files[i];
     }
 
-    return (CorePluginType)m64p_type;
+    return true;
 }
 
-std::string get_plugin_name(m64p::PluginApi* plugin, std::string filename)
+static std::filesystem::path get_plugin_cache_file_path(void)
 {
-    m64p_error ret;
-    const char* name = nullptr;
-    
-    ret = plugin->GetVersion(nullptr, nullptr, nullptr, &name, nullptr);
-    if (ret != M64ERR_SUCCESS || 
-        name == nullptr)
+    const char* cachePath = m64p::Config.GetUserCachePath();
+    if (cachePath == nullptr)
     {
-        return filename;
+        return std::filesystem::path();
     }
 
-    return std::string(name);
+    return std::filesystem::path(cachePath) / PLUGIN_CACHE_FILE_NAME;
 }
 
-//
-// Exported Functions
-//
+template <typename T>
+static bool parse_number(const std::string& str, T& value)
+{
+    auto result = std::from_chars(str.data(), str.data() + str.size(), value);
+    return result.ec == std::errc() && result.ptr == str.data() + str.size();
+}
 
-std::vector<CorePlugin> CoreGetAllPlugins(void)
+static void plugin_cache_read(void)
 {
-    std::vector<CorePlugin> plugins;
-    std::string             plugin_name;
-    CorePluginType          plugin_type;
-    osal_dynlib_lib_handle  handle;
-    m64p::PluginApi         plugin;
+    std::ifstream stream(get_plugin_cache_file_path(), std::ios::binary);
+    std::string line;
 
-    for (const auto& entry : std::filesystem::recursive_directory_iterator("Plugin"))
+    while (std::getline(stream, line))
     {
-        std::string path = entry.path().string();
-        if (!entry.is_directory() &&
-            path.ends_with(OSAL_DYNLIB_LIB_EXT_STR))
-        {
-            handle = osal_dynlib_open(path.c_str());
-            if (handle == nullptr || !plugin.Hook(handle))
-            { // skip invalid libs
-                continue;
-            }
+        std::vector<std::string> fields;
+        size_t start = 0;
+        size_t end;
 
-            plugin_name = get_plugin_name(&plugin, entry.path().filename().string());
-            plugin_type = get_plugin_type(&plugin);
+        while ((end = line.find('\t', start)) != std::string::npos)
+        {
+            fields.emplace_back(line.substr(start, end - start));
+            start = end + 1;
+        }
+        fields.emplace_back(line.substr(start));
 
-            plugin.Unhook();
-            osal_dynlib_close(handle);
+        if (fields.size() != PLUGIN_CACHE_FIELDS)
+        { // skip invalid entry
+            continue;
+        }
 
-            if (plugin_type == CorePluginType::Invalid)
-            { // skip unsupported plugin types
-                continue;
-            }
+        l_PluginCacheEntry entry;
+        int type;
+        int hasConfig;
+        int hasAudioCapture;
+
+        if (!parse_number(fields[1], entry.FileSize) ||
+            !parse_number(fields[2], entry.FileTime) ||
+            !parse_number(fields[3], type) ||
+            !parse_number(fields[4], entry.Plugin.Version) ||
+            !parse_number(fields[5], entry.Plugin.ApiVersion) ||
+            !parse_number(fields[6], hasConfig) ||
+            !parse_number(fields[7], hasAudioCapture))
+        { // skip invalid entry
+            continue;
+        }
 
-            CorePlugin corePlugin = {path, plugin_name, plugin_type};
-            plugins.emplace_back(corePlugin);
+        if (type < (int)CorePluginType::Rsp || type > (int)CorePluginType::Invalid)
+        { // skip invalid entry
+            continue;
         }
+
+        entry.Plugin.File = fields[0];
+        entry.Plugin.Name = fields[8];
+        entry.Plugin.Type = (CorePluginType)type;
+        entry.Plugin.HasConfig = hasConfig != 0;
+        entry.Plugin.HasAudioCapture = hasAudioCapture != 0;
+        l_PluginCache[fields[0]] = entry;
     }
 
-    return plugins;
+    l_PluginCacheLoaded = true;
 }
 
-bool CoreApplyPluginSettings(void)
+static bool plugin_cache_write(void)
 {
-    std::string            error;
-    std::string            settingValue;
-    m64p::PluginApi*       plugin;
-    osal_dynlib_lib_handle handle;
-    m64p_error             ret;
+    std::string error;
+    std::error_code errorCode;
 
-    SettingsID settings[] = 
+    std::filesystem::path filePath = get_plugin_cache_file_path();
+    std::filesystem::path tmpFilePath = filePath;
+    tmpFilePath += ".tmp";
+
+    std::ofstream stream(tmpFilePath, std::ios::binary | std::ios::trunc);
+    if (!stream.is_open())
     {
-        SettingsID::Core_RSP_Plugin,
-        SettingsID::Core_GFX_Plugin,
-        SettingsID::Core_AUDIO_Plugin,
-        SettingsID::Core_INPUT_Plugin
-    };
+        error = "plugin_cache_write Failed: cannot open ";
+        error += tmpFilePath.string();
+        CoreSetError(error);
+        return false;
+    }
 
-    for (int i = 0; i < 4; i++)
+    for (const auto& entry : l_PluginCache)
     {
-        settingValue = CoreSettingsGetStringValue(settings[i]);
-        if (settingValue.empty() ||
-            !std::filesystem::is_regular_file(settingValue))
-        { // skip invalid setting value
-            continue;
-        }
+        const CorePlugin& plugin = entry.second.Plugin;
 
-        if (settingValue != l_PluginFiles[i])
+        // strings containing separators can't be stored
+        if (entry.first.find_first_of("\t\n") != std::string::npos ||
+            plugin.Name.find_first_of("\t\n") != std::string::npos)
         {
-            plugin = &l_Plugins[i];
-
-            // shutdown plugin when hooked
-            if (plugin->IsHooked())
-            {
-                ret = plugin->Shutdown();
-                if (ret != M64ERR_SUCCESS)
-                {
-                    error = "CoreApplyPluginSettings m64p::PluginApi.Shutdown() Failed: ";
-                    error += m64p::Core.ErrorMessage(ret);
-                    CoreSetError(error);
-                    return false;
-                }
-
-                // reset plugin
-                plugin->Unhook();
-            }
-
-            // attempt to open the library
-            handle = osal_dynlib_open(settingValue.c_str());
-            if (handle == nullptr)
-            {
-                error = "CoreApplyPluginSettings osal_dynlib_open Failed: ";
-                error += osal_dynlib_strerror();
-                CoreSetError(error);
-                return false;
-            }
-
-            // attempt to hook the library
-            if (!plugin->Hook(handle))
-            {
-                error = "CoreApplyPluginSettings m64p::PluginApi.Hook() Failed: ";
-                error += plugin->GetLastError();
-                CoreSetError(error);
-                return false;
-            }
-
-            // attempt to start plugin
-            ret = plugin->Startup(m64p::Core.GetHandle(), nullptr, nullptr);
-            if (ret != M64ERR_SUCCESS)
-            {
-                error = "CoreApplyPluginSettings m64p::PluginApi.Startup() Failed: ";
-                error += m64p::Core.ErrorMessage(ret);
-                CoreSetError(error);
-                return false;
-            }
-
-            l_PluginFiles[i] = settingValue;
+            continue;
         }
+
+        stream << entry.first << '\t'
+               << entry.second.FileSize << '\t'
+               << entry.second.FileTime << '\t'
+               << (int)plugin.Type << '\t'
+               << plugin.Version << '\t'
+               << plugin.ApiVersion << '\t'
+               << (int)plugin.HasConfig << '\t'
+               << (int)plugin.HasAudioCapture << '\t'
+               << plugin.Name << '\n';
+    }
+
+    stream.close();
+    if (stream.fail())
+    {
+        error = "plugin_cache_write Failed: cannot write ";
+        error += tmpFilePath.string();
+        CoreSetError(error);
+        std::filesystem::remove(tmpFilePath, errorCode);
+        return false;
+    }
+
+    std::filesystem::rename(tmpFilePath, filePath, errorCode);
+    if (errorCode)
+    {
+        error = "plugin_cache_write std::filesystem::rename Failed: ";
+        error += errorCode.message();
+        CoreSetError(error);
+        std::filesystem::remove(tmpFilePath, errorCode);
+        return false;
     }
 
     return true;
 }
 
-bool CoreApplyRomPluginSettings(void)
+// opens the plugin to retrieve its information,
+// invalid libraries return CorePluginType::Invalid
+static CorePlugin probe_plugin(const std::filesystem::path& path)
 {
-    std::string            error;
-    std::string            settingValue;
-    m64p::PluginApi*       plugin;
+    CorePlugin             corePlugin;
     osal_dynlib_lib_handle handle;
+    m64p::PluginApi        plugin;
+    m64p_plugin_type       m64p_type = M64PLUGIN_NULL;
+    const char*            name = nullptr;
     m64p_error             ret;
-    CoreRomSettings        romSettings;
 
-    SettingsID settings[] = 
+    corePlugin.File = path.string();
+    corePlugin.Name = path.filename().string();
+    corePlugin.Type = CorePluginType::Invalid;
+    corePlugin.Version = 0;
+    corePlugin.ApiVersion = 0;
+    corePlugin.HasConfig = false;
+    corePlugin.HasAudioCapture = false;
+
+    handle = osal_dynlib_open(corePlugin.File.c_str());
+    if (handle == nullptr)
     {
-        SettingsID::Game_RSP_Plugin,
-        SettingsID::Game_GFX_Plugin,
-        SettingsID::Game_AUDIO_Plugin,
-        SettingsID::Game_INPUT_Plugin
-    };
+        return corePlugin;
+    }
 
-    if (!CoreGetCurrentDefaultRomSettings(romSettings))
+    if (!plugin.Hook(handle))
     {
-        return false;
+        osal_dynlib_close(handle);
+        return corePlugin;
     }
 
-    for (int i = 0; i < 4; i++)
+    ret = plugin.GetVersion(&m64p_type, &corePlugin.Version, &corePlugin.ApiVersion, &name, nullptr);
+    if (ret == M64ERR_SUCCESS)
     {
-        settingValue = CoreSettingsGetStringValue(settings[i], romSettings.MD5);
-        if (settingValue.empty() ||
-            !std::filesystem::is_regular_file(settingValue))
-        { // skip invalid setting value
+        if (m64p_type >= 1 && m64p_type <= 4)
+        {
+            corePlugin.Type = (CorePluginType)m64p_type;
+        }
+
+        if (name != nullptr)
+        {
+            corePlugin.Name = name;
+        }
+    }
+
+    corePlugin.HasConfig = plugin.Config != nullptr;
+    corePlugin.HasAudioCapture = plugin.AudioCapture != nullptr;
+
+    plugin.Unhook();
+    osal_dynlib_close(handle);
+
+    return corePlugin;
+}
+
+//
+// Exported Functions
+//
+
+std::vector<CorePlugin> CoreGetAllPlugins(void)
+{
+    std::lock_guard<std::mutex> lock(l_PluginCacheMutex);
+    std::vector<CorePlugin> plugins;
+    std::unordered_map<std::string, l_PluginCacheEntry> pluginCache;
+    std::error_code         errorCode;
+    bool                    cacheChanged = false;
+
+    if (!l_PluginCacheLoaded)
+    {
+        plugin_cache_read();
+    }
+
+    for (const auto& entry : std::filesystem::recursive_directory_iterator("Plugin", errorCode))
+    {
+        std::string path = entry.path().string();
+        if (entry.is_directory() ||
+            !path.ends_with(OSAL_DYNLIB_LIB_EXT_STR))
+        {
+            continue;
+        }
+
+        uintmax_t fileSize = entry.file_size(errorCode);
+        if (errorCode)
+        {
             continue;
         }
 
-        if (settingValue != l_PluginFiles[i])
+        int64_t fileTime = entry.last_write_time(errorCode).time_since_epoch().count();
+        if (errorCode)
         {
-            plugin = &l_Plugins[i];
-
-            // shutdown plugin when hooked
-            if (plugin->IsHooked())
-            {
-                ret = plugin->Shutdown();
-                if (ret != M64ERR_SUCCESS)
-                {
-                    error = "CoreApplyRomPluginSettings m64p::PluginApi.Shutdown() Failed: ";
-                    error += m64p::Core.ErrorMessage(ret);
-                    CoreSetError(error);
-                    return false;
-                }
-
-                // reset plugin
-                plugin->Unhook();
-            }
-
-            // attempt to open the library
-            handle = osal_dynlib_open(settingValue.c_str());
-            if (handle == nullptr)
-            {
-                error = "CoreApplyRomPluginSettings osal_dynlib_open Failed: ";
-                error += osal_dynlib_strerror();
-                CoreSetError(error);
-                return false;
-            }
-
-            // attempt to hook the library
-            if (!plugin->Hook(handle))
-            {
-                error = "CoreApplyRomPluginSettings m64p::PluginApi.Hook() Failed: ";
-                error += plugin->GetLastError();
-                CoreSetError(error);
-                return false;
-            }
-
-            // attempt to start plugin
-            ret = plugin->Startup(m64p::Core.GetHandle(), nullptr, nullptr);
-            if (ret != M64ERR_SUCCESS)
-            {
-                error = "CoreApplyRomPluginSettings m64p::PluginApi.Startup() Failed: ";
-                error += m64p::Core.ErrorMessage(ret);
-                CoreSetError(error);
-                return false;
-            }
-
-            l_PluginFiles[i] = settingValue;
+            continue;
+        }
+
+        // only open the plugin when it has changed
+        auto iter = l_PluginCache.find(path);
+        if (iter == l_PluginCache.end() ||
+            iter->second.FileSize != fileSize ||
+            iter->second.FileTime != fileTime)
+        {
+            pluginCache[path] = {fileSize, fileTime, probe_plugin(entry.path())};
+            cacheChanged = true;
         }
+        else
+        {
+            pluginCache[path] = iter->second;
+        }
+
+        const CorePlugin& plugin = pluginCache[path].Plugin;
+        if (plugin.Type == CorePluginType::Invalid)
+        { // skip invalid libs and unsupported plugin types
+            continue;
+        }
+
+        plugins.emplace_back(plugin);
     }
 
-    return true;
+    // removed plugins are dropped from the cache
+    if (pluginCache.size() != l_PluginCache.size())
+    {
+        cacheChanged = true;
+    }
+
+    l_PluginCache = std::move(pluginCache);
+
+    if (cacheChanged)
+    {
+        // not being able to save the cache isn't fatal,
+        // the plugins will be opened again next time
+        plugin_cache_write();
+    }
+
+    return plugins;
+}
+
+bool CoreApplyPluginSettings(void)
+{
+    std::lock_guard<std::recursive_mutex> lock(l_PluginsMutex);
+
+    std::string files[] =
+    {
+        CoreSettingsGetStringValue(SettingsID::Core_RSP_Plugin),
+        CoreSettingsGetStringValue(SettingsID::Core_GFX_Plugin),
+        CoreSettingsGetStringValue(SettingsID::Core_AUDIO_Plugin),
+        CoreSettingsGetStringValue(SettingsID::Core_INPUT_Plugin)
+    };
+
+    return apply_plugin_files(files, "CoreApplyPluginSettings");
+}
+
+bool CoreApplyRomPluginSettings(void)
+{
+    std::lock_guard<std::recursive_mutex> lock(l_PluginsMutex);
+    CoreRomSettings romSettings;
+
+    if (!CoreGetCurrentDefaultRomSettings(romSettings))
+    {
+        return false;
+    }
+
+    std::string files[] =
+    {
+        CoreSettingsGetStringValue(SettingsID::Game_RSP_Plugin, romSettings.MD5),
+        CoreSettingsGetStringValue(SettingsID::Game_GFX_Plugin, romSettings.MD5),
+        CoreSettingsGetStringValue(SettingsID::Game_AUDIO_Plugin, romSettings.MD5),
+        CoreSettingsGetStringValue(SettingsID::Game_INPUT_Plugin, romSettings.MD5)
+    };
+
+    return apply_plugin_files(files, "CoreApplyRomPluginSettings");
+}
+
+bool CoreApplyPluginFiles(std::string rspFile, std::string gfxFile, std::string audioFile, std::string inputFile)
+{
+    std::lock_guard<std::recursive_mutex> lock(l_PluginsMutex);
+
+    std::string files[] =
+    {
+        rspFile,
+        gfxFile,
+        audioFile,
+        inputFile
+    };
+
+    return apply_plugin_files(files, "CoreApplyPluginFiles");
 }
 
 bool CoreArePluginsReady(void)
 {
+    std::lock_guard<std::recursive_mutex> lock(l_PluginsMutex);
     std::string error;
 
     for (int i = 0; i < 4; i++)
     {
-        if (!l_Plugins[i].IsHooked())
+        if (l_Plugins[i] == nullptr || !l_Plugins[i]->IsHooked())
         {
             error = "CoreArePluginsReady Failed: ";
             error += "PluginApi::IsHooked returned false!";
@@ -303,6 +513,7 @@ bool CoreArePluginsReady(void)
 
 bool CorePluginsHasConfig(CorePluginType type)
 {
+    std::lock_guard<std::recursive_mutex> lock(l_PluginsMutex);
     return get_plugin(type)->Config != nullptr;
 }
 
@@ -311,8 +522,13 @@ bool CorePluginsOpenConfig(CorePluginType type)
     std::string error;
     m64p_error ret;
     bool resumeEmulation = false;
+    m64p::PluginApi* plugin;
 
-    if (!CorePluginsHasConfig(type))
+    // the lock isn't held while the config dialog is shown,
+    // which is fine because the plugin stays in the pool
+    plugin = get_plugin(type);
+
+    if (plugin->Config == nullptr)
     {
         error = "CorePluginsOpenConfig Failed: ";
         error += "plugin with given type doesn't have config function!";
@@ -331,7 +547,13 @@ bool CorePluginsOpenConfig(CorePluginType type)
         resumeEmulation = CorePauseEmulation();
     }
 
-    ret = get_plugin(type)->Config();
+    {
+        // the settings writer thread mustn't
+        // serialize while the plugin changes the config
+        std::lock_guard<std::recursive_mutex> settingsLock(CoreSettingsGetMutex());
+        ret = plugin->Config();
+    }
+
     if (ret != M64ERR_SUCCESS)
     {
         error = "CorePluginsOpenConfig m64p::PluginApi.Config() Failed: ";
@@ -339,6 +561,9 @@ bool CorePluginsOpenConfig(CorePluginType type)
         CoreSetError(error);
     }
 
+    // the plugin might've changed its settings
+    CoreSettingsInvalidate();
+
     // try to resume emulation when needed
     if (resumeEmulation)
     {
@@ -348,8 +573,80 @@ bool CorePluginsOpenConfig(CorePluginType type)
     return ret == M64ERR_SUCCESS;
 }
 
+bool CorePluginsSetAudioCaptureCallback(void (*callback)(const void* samples, int length, int frequency))
+{
+    std::lock_guard<std::recursive_mutex> lock(l_PluginsMutex);
+    std::string error;
+    m64p_error ret;
+    m64p::PluginApi* plugin;
+
+    plugin = get_plugin(CorePluginType::Audio);
+    if (plugin->AudioCapture == nullptr)
+    {
+        error = "CorePluginsSetAudioCaptureCallback Failed: ";
+        error += "audio plugin doesn't support capturing!";
+        CoreSetError(error);
+        return false;
+    }
+
+    ret = plugin->AudioCapture(callback);
+    if (ret != M64ERR_SUCCESS)
+    {
+        error = "CorePluginsSetAudioCaptureCallback m64p::PluginApi.AudioCapture() Failed: ";
+        error += m64p::Core.ErrorMessage(ret);
+        CoreSetError(error);
+    }
+
+    return ret == M64ERR_SUCCESS;
+}
+
+bool CorePluginsSetAudioDiscard(bool discard)
+{
+    std::lock_guard<std::recursive_mutex> lock(l_PluginsMutex);
+    std::string error;
+    m64p_error ret;
+    m64p::PluginApi* plugin;
+
+    plugin = get_plugin(CorePluginType::Audio);
+    if (plugin->AudioDiscard == nullptr)
+    {
+        error = "CorePluginsSetAudioDiscard Failed: ";
+        error += "audio plugin doesn't support discarding!";
+        CoreSetError(error);
+        return false;
+    }
+
+    ret = plugin->AudioDiscard(discard ? 1 : 0);
+    if (ret != M64ERR_SUCCESS)
+    {
+        error = "CorePluginsSetAudioDiscard m64p::PluginApi.AudioDiscard() Failed: ";
+        error += m64p::Core.ErrorMessage(ret);
+        CoreSetError(error);
+    }
+
+    return ret == M64ERR_SUCCESS;
+}
+
+bool CorePluginsSetAudioSpeedFactor(int factor)
+{
+    std::lock_guard<std::recursive_mutex> lock(l_PluginsMutex);
+    m64p::PluginApi* plugin;
+
+    plugin = get_plugin(CorePluginType::Audio);
+    if (plugin->SetSpeedFactor == nullptr)
+    {
+        CoreSetError("CorePluginsSetAudioSpeedFactor Failed: audio plugin doesn't support SetSpeedFactor!");
+        return false;
+    }
+
+    plugin->SetSpeedFactor(factor);
+    return true;
+}
+
 bool CoreAttachPlugins(void)
 {
+    std::lock_guard<std::recursive_mutex> lock(l_PluginsMutex);
+    std::lock_guard<std::recursive_mutex> settingsLock(CoreSettingsGetMutex());
     std::string error;
     m64p_error ret;
     m64p_plugin_type plugin_types[] =
@@ -397,30 +694,37 @@ bool CoreDetachPlugins(void)
 
 bool CorePluginsShutdown(void)
 {
-    std::string      error;
-    m64p::PluginApi* plugin;
-    m64p_error       ret;
+    std::lock_guard<std::recursive_mutex> lock(l_PluginsMutex);
+    std::string            error;
+    osal_dynlib_lib_handle handle;
+    m64p_error             ret;
+    bool                   success = true;
 
     for (int i = 0; i < 4; i++)
     {
-        plugin = &l_Plugins[i];
+        l_Plugins[i] = nullptr;
+        l_PluginFiles[i].clear();
+    }
 
-        // shutdown plugin when hooked
-        if (plugin->IsHooked())
+    for (auto& pooledPlugin : l_PluginPool)
+    {
+        m64p::PluginApi* plugin = pooledPlugin.second.get();
+
+        ret = plugin->Shutdown();
+        if (ret != M64ERR_SUCCESS)
         {
-            ret = plugin->Shutdown();
-            if (ret != M64ERR_SUCCESS)
-            {
-                error = "CorePluginsShutdown m64p::PluginApi.Shutdown() Failed: ";
-                error += m64p::Core.ErrorMessage(ret);
-                CoreSetError(error);
-                break;
-            }
-
-            // reset plugin
-            plugin->Unhook();
+            error = "CorePluginsShutdown m64p::PluginApi.Shutdown() Failed: ";
+            error += m64p::Core.ErrorMessage(ret);
+            CoreSetError(error);
+            success = false;
+            continue;
         }
+
+        handle = plugin->GetHandle();
+        plugin->Unhook();
+        osal_dynlib_close(handle);
     }
 
-    return ret == M64ERR_SUCCESS;
+    l_PluginPool.clear();
+    return success;
 }
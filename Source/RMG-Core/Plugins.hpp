@@ -27,9 +27,17 @@ struct CorePlugin
     std::string    File;
     std::string    Name;
     CorePluginType Type;
+    int            Version;
+    int            ApiVersion;
+    bool           HasConfig;
+    bool           HasAudioCapture;
 };
 
-// retrieves all available plugins
+// retrieves all available plugins,
+// only plugins which have changed since
+// the last time are opened to retrieve
+// their information, the others are
+// retrieved from the plugin cache
 std::vector<CorePlugin> CoreGetAllPlugins(void);
 
 // applies updated plugin settings,
@@ -40,6 +48,11 @@ bool CoreApplyPluginSettings(void);
 // i.e when you launch a ROM
 bool CoreApplyRomPluginSettings(void);
 
+// applies the given plugin files without changing
+// the plugin settings, an empty file keeps the
+// currently used plugin of that type
+bool CoreApplyPluginFiles(std::string rspFile, std::string gfxFile, std::string audioFile, std::string inputFile);
+
 // checks wether all plugins are
 // hooked and ready for emulation
 bool CoreArePluginsReady(void);
@@ -52,6 +65,22 @@ bool CorePluginsHasConfig(CorePluginType type);
 // used plugin of given type
 bool CorePluginsOpenConfig(CorePluginType type);
 
+// sets the callback which receives the PCM samples
+// of the currently used audio plugin, pass nullptr
+// to stop capturing, fails when the plugin
+// doesn't support capturing
+bool CorePluginsSetAudioCaptureCallback(void (*callback)(const void* samples, int length, int frequency));
+
+// sets whether the currently used audio plugin
+// discards the samples it receives, fails when
+// the plugin doesn't support discarding
+bool CorePluginsSetAudioDiscard(bool discard);
+
+// passes the speed factor in percent to the
+// currently used audio plugin, fails when the
+// plugin isn't an audio plugin
+bool CorePluginsSetAudioSpeedFactor(int factor);
+
 // attaches all used plugins
 bool CoreAttachPlugins(void);
 
@@ -0,0 +1,471 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#define CORE_INTERNAL
+#include "Rewind.hpp"
+#include "Settings/Settings.hpp"
+#include "SaveState.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//
+// Local Defines
+//
+
+// a full state is stored every REWIND_KEYFRAME_INTERVAL
+// captures, the other captures only store the
+// difference to the last full state
+#define REWIND_KEYFRAME_INTERVAL 60
+
+// amount of full size state buffers which are kept
+// besides the entries: the key frame, the captured state,
+// the state handed over to the worker, the state the worker
+// encodes and the restored state
+#define REWIND_STATE_BUFFERS 5
+
+//
+// Local Structures
+//
+
+struct l_RewindEntry
+{
+    uint64_t             KeyFrameId;
+    bool                 IsKeyFrame;
+    size_t               StateSize;
+    std::vector<uint8_t> Data;
+};
+
+struct l_RewindWorker
+{
+    std::thread thread;
+    std::condition_variable condition;
+    std::vector<uint8_t> buffer;
+    bool pending = false;
+    bool busy = false;
+    bool stop = false;
+};
+
+//
+// Local Variables
+//
+
+static std::atomic<bool> l_RewindEnabled = false;
+static std::atomic<bool> l_Rewinding = false;
+
+// only used on the emulation thread
+static int                  l_CaptureInterval = 1;
+static int                  l_FrameCount = 0;
+static std::vector<uint8_t> l_CaptureBuffer;
+static std::vector<uint8_t> l_RestoreBuffer;
+
+// the key frame is only used by the worker thread,
+// or by the emulation thread when the worker is idle
+static std::vector<uint8_t> l_KeyFrame;
+static uint64_t             l_KeyFrameId = 0;
+
+static std::mutex                l_RewindMutex;
+static std::deque<l_RewindEntry> l_RewindEntries;
+static size_t                    l_RewindMemoryBudget = 0;
+static size_t                    l_RewindMemoryUsed = 0;
+static uint64_t                  l_NextKeyFrameId = 1;
+static int                       l_CapturesSinceKeyFrame = 0;
+static bool                      l_ForceKeyFrame = true;
+static l_RewindWorker            l_RewindWorker;
+
+//
+// Local Functions
+//
+
+// reads 64 bit word at index, the last
+// word is padded with zeros when needed
+static uint64_t read_word(const uint8_t* data, size_t index, size_t size)
+{
+    uint64_t word = 0;
+    size_t offset = index * sizeof(uint64_t);
+    std::memcpy(&word, data + offset, std::min(sizeof(uint64_t), size - offset));
+    return word;
+}
+
+static void write_word(uint8_t* data, size_t index, size_t size, uint64_t word)
+{
+    size_t offset = index * sizeof(uint64_t);
+    std::memcpy(data + offset, &word, std::min(sizeof(uint64_t), size - offset));
+}
+
+static void append_uint32(std::vector<uint8_t>& output, uint32_t value)
+{
+    size_t offset = output.size();
+    output.resize(offset + sizeof(value));
+    std::memcpy(output.data() + offset, &value, sizeof(value));
+}
+
+// encodes data as runs of unchanged words followed by
+// runs of changed words, when reference is given only
+// the xor difference to it is stored, so mostly unchanged
+// states only need a fraction of their size
+static void rewind_encode(const uint8_t* data, const uint8_t* reference, size_t size, std::vector<uint8_t>& output)
+{
+    size_t words = (size + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    size_t index = 0;
+
+    output.clear();
+
+    while (index < words)
+    {
+        uint32_t unchanged = 0;
+        uint32_t changed = 0;
+        size_t changedStart;
+
+        while (index < words && unchanged < UINT32_MAX &&
+                (read_word(data, index, size) ^ (reference ? read_word(reference, index, size) : 0)) == 0)
+        {
+            unchanged++;
+            index++;
+        }
+
+        changedStart = index;
+        while (index < words && changed < UINT32_MAX &&
+                (read_word(data, index, size) ^ (reference ? read_word(reference, index, size) : 0)) != 0)
+        {
+            changed++;
+            index++;
+        }
+
+        append_uint32(output, unchanged);
+        append_uint32(output, changed);
+
+        size_t offset = output.size();
+        output.resize(offset + (changed * sizeof(uint64_t)));
+        for (size_t i = changedStart; i < index; i++)
+        {
+            uint64_t word = read_word(data, i, size) ^ (reference ? read_word(reference, i, size) : 0);
+            std::memcpy(output.data() + offset, &word, sizeof(word));
+            offset += sizeof(word);
+        }
+    }
+
+    output.shrink_to_fit();
+}
+
+// applies the encoded difference to output
+static void rewind_decode(const std::vector<uint8_t>& input, uint8_t* output, size_t size)
+{
+    size_t words = (size + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    size_t offset = 0;
+    size_t index = 0;
+
+    while (offset + (sizeof(uint32_t) * 2) <= input.size())
+    {
+        uint32_t unchanged;
+        uint32_t changed;
+
+        std::memcpy(&unchanged, input.data() + offset, sizeof(unchanged));
+        std::memcpy(&changed, input.data() + offset + sizeof(unchanged), sizeof(changed));
+        offset += sizeof(uint32_t) * 2;
+        index += unchanged;
+
+        for (uint32_t i = 0; i < changed && index < words; i++, index++)
+        {
+            uint64_t word;
+            std::memcpy(&word, input.data() + offset, sizeof(word));
+            offset += sizeof(word);
+
+            write_word(output, index, size, read_word(output, index, size) ^ word);
+        }
+    }
+}
+
+// removes the oldest groups (a key frame and its deltas)
+// until the entries and the state buffers fit in the memory
+// budget, the newest group is never removed, because new
+// deltas may depend on its key frame, so the budget can be
+// exceeded when it's too small
+static void rewind_evict_entries(size_t stateSize)
+{
+    size_t buffersSize = stateSize * REWIND_STATE_BUFFERS;
+    size_t budget = l_RewindMemoryBudget > buffersSize ? (l_RewindMemoryBudget - buffersSize) : 0;
+
+    while (l_RewindMemoryUsed > budget && !l_RewindEntries.empty())
+    {
+        auto groupEnd = std::find_if(l_RewindEntries.begin() + 1, l_RewindEntries.end(), [](const l_RewindEntry& e)
+        {
+            return e.IsKeyFrame;
+        });
+
+        if (groupEnd == l_RewindEntries.end())
+        {
+            break;
+        }
+
+        // new deltas can't reference
+        // a key frame which has been removed
+        if (l_RewindEntries.front().KeyFrameId == l_KeyFrameId)
+        {
+            l_ForceKeyFrame = true;
+        }
+
+        for (auto iter = l_RewindEntries.begin(); iter != groupEnd; iter++)
+        {
+            l_RewindMemoryUsed -= iter->Data.size();
+        }
+        l_RewindEntries.erase(l_RewindEntries.begin(), groupEnd);
+    }
+}
+
+static void rewind_worker_thread(void)
+{
+    std::unique_lock<std::mutex> lock(l_RewindMutex);
+    std::vector<uint8_t> state;
+
+    while (!l_RewindWorker.stop)
+    {
+        l_RewindWorker.condition.wait(lock, []
+        {
+            return l_RewindWorker.pending || l_RewindWorker.stop;
+        });
+
+        if (l_RewindWorker.stop)
+        {
+            break;
+        }
+
+        state.swap(l_RewindWorker.buffer);
+        l_RewindWorker.pending = false;
+        l_RewindWorker.busy = true;
+
+        l_RewindEntry entry;
+        entry.StateSize = state.size();
+        entry.IsKeyFrame = l_ForceKeyFrame ||
+                            l_KeyFrameId == 0 ||
+                            l_KeyFrame.size() != state.size() ||
+                            l_CapturesSinceKeyFrame >= REWIND_KEYFRAME_INTERVAL;
+        if (entry.IsKeyFrame)
+        {
+            l_KeyFrameId = l_NextKeyFrameId++;
+            l_CapturesSinceKeyFrame = 0;
+            l_ForceKeyFrame = false;
+        }
+        entry.KeyFrameId = l_KeyFrameId;
+        l_CapturesSinceKeyFrame++;
+        lock.unlock();
+
+        if (entry.IsKeyFrame)
+        {
+            l_KeyFrame = state;
+            rewind_encode(state.data(), nullptr, state.size(), entry.Data);
+        }
+        else
+        {
+            rewind_encode(state.data(), l_KeyFrame.data(), state.size(), entry.Data);
+        }
+
+        lock.lock();
+        l_RewindMemoryUsed += entry.Data.size();
+        l_RewindEntries.emplace_back(std::move(entry));
+        rewind_evict_entries(state.size());
+
+        l_RewindWorker.busy = false;
+        l_RewindWorker.condition.notify_all();
+    }
+}
+
+// hands the captured state over to the worker,
+// an older state which the worker hasn't
+// started on yet is replaced
+static void rewind_capture(void)
+{
+    if (!CoreSaveStateToBuffer(l_CaptureBuffer))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(l_RewindMutex);
+    l_RewindWorker.buffer.swap(l_CaptureBuffer);
+    l_RewindWorker.pending = true;
+    l_RewindWorker.condition.notify_all();
+}
+
+// restores the most recent captured state
+static void rewind_restore(void)
+{
+    std::unique_lock<std::mutex> lock(l_RewindMutex);
+
+    // wait for the worker to store the pending state
+    l_RewindWorker.condition.wait(lock, []
+    {
+        return (!l_RewindWorker.pending && !l_RewindWorker.busy) || l_RewindWorker.stop;
+    });
+
+    if (l_RewindEntries.empty())
+    {
+        return;
+    }
+
+    const l_RewindEntry& entry = l_RewindEntries.back();
+    l_RestoreBuffer.resize(entry.StateSize);
+
+    if (entry.IsKeyFrame)
+    {
+        std::fill(l_RestoreBuffer.begin(), l_RestoreBuffer.end(), 0);
+        rewind_decode(entry.Data, l_RestoreBuffer.data(), l_RestoreBuffer.size());
+        l_KeyFrame = l_RestoreBuffer;
+        l_KeyFrameId = entry.KeyFrameId;
+    }
+    else
+    {
+        // decode the key frame of the entry
+        // when it isn't the current one
+        if (l_KeyFrameId != entry.KeyFrameId)
+        {
+            auto keyFrame = std::find_if(l_RewindEntries.rbegin(), l_RewindEntries.rend(), [&entry](const l_RewindEntry& e)
+            {
+                return e.IsKeyFrame && e.KeyFrameId == entry.KeyFrameId;
+            });
+
+            // drop the entry when its key frame is missing,
+            // so the next rewind continues with the one before
+            if (keyFrame == l_RewindEntries.rend())
+            {
+                l_RewindMemoryUsed -= entry.Data.size();
+                l_RewindEntries.pop_back();
+                l_ForceKeyFrame = true;
+                return;
+            }
+
+            l_KeyFrame.assign(keyFrame->StateSize, 0);
+            rewind_decode(keyFrame->Data, l_KeyFrame.data(), l_KeyFrame.size());
+            l_KeyFrameId = keyFrame->KeyFrameId;
+        }
+
+        l_RestoreBuffer = l_KeyFrame;
+        rewind_decode(entry.Data, l_RestoreBuffer.data(), l_RestoreBuffer.size());
+    }
+
+    // keep the oldest state, so rewinding
+    // further keeps restoring it
+    if (l_RewindEntries.size() > 1)
+    {
+        l_RewindMemoryUsed -= entry.Data.size();
+        l_RewindEntries.pop_back();
+    }
+
+    // the key frame of new captures
+    // may have been removed
+    l_ForceKeyFrame = true;
+    lock.unlock();
+
+    CoreLoadStateFromBuffer(l_RestoreBuffer);
+    l_FrameCount = 0;
+}
+
+//
+// Internal Functions
+//
+
+void CoreRewindStart(void)
+{
+    CoreRewindStop();
+
+    if (!CoreSettingsGetBoolValue(SettingsID::Core_RewindEnabled) ||
+        !CoreSupportsSaveStateBuffers())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(l_RewindMutex);
+
+    l_CaptureInterval = std::max(1, CoreSettingsGetIntValue(SettingsID::Core_RewindInterval));
+    l_RewindMemoryBudget = (size_t)std::max(1, CoreSettingsGetIntValue(SettingsID::Core_RewindBufferSize)) * 1024 * 1024;
+    l_FrameCount = 0;
+    l_ForceKeyFrame = true;
+
+    l_RewindWorker.stop = false;
+    l_RewindWorker.thread = std::thread(rewind_worker_thread);
+
+    l_RewindEnabled = true;
+}
+
+void CoreRewindStop(void)
+{
+    l_RewindEnabled = false;
+    l_Rewinding = false;
+
+    {
+        std::lock_guard<std::mutex> lock(l_RewindMutex);
+        l_RewindWorker.stop = true;
+        l_RewindWorker.condition.notify_all();
+    }
+
+    if (l_RewindWorker.thread.joinable())
+    {
+        l_RewindWorker.thread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(l_RewindMutex);
+    l_RewindWorker.pending = false;
+    l_RewindWorker.busy = false;
+    l_RewindEntries.clear();
+    l_RewindMemoryUsed = 0;
+    l_KeyFrameId = 0;
+
+    // free the buffers
+    std::vector<uint8_t>().swap(l_RewindWorker.buffer);
+    std::vector<uint8_t>().swap(l_CaptureBuffer);
+    std::vector<uint8_t>().swap(l_RestoreBuffer);
+    std::vector<uint8_t>().swap(l_KeyFrame);
+}
+
+void CoreRewindOnFrame(void)
+{
+    if (!l_RewindEnabled)
+    {
+        return;
+    }
+
+    if (l_Rewinding)
+    {
+        rewind_restore();
+        return;
+    }
+
+    if (++l_FrameCount < l_CaptureInterval)
+    {
+        return;
+    }
+
+    l_FrameCount = 0;
+    rewind_capture();
+}
+
+//
+// Exported Functions
+//
+
+bool CoreIsRewindEnabled(void)
+{
+    return l_RewindEnabled;
+}
+
+void CoreSetRewinding(bool rewinding)
+{
+    l_Rewinding = rewinding && l_RewindEnabled;
+}
+
+bool CoreIsRewinding(void)
+{
+    return l_Rewinding;
+}
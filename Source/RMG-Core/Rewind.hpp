@@ -0,0 +1,42 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_REWIND_HPP
+#define CORE_REWIND_HPP
+
+// internal rewind functions
+#ifdef CORE_INTERNAL
+
+// starts capturing states when rewind is
+// enabled, called before emulation starts
+void CoreRewindStart(void);
+
+// stops capturing states and frees
+// them, called after emulation stopped
+void CoreRewindStop(void);
+
+// captures or restores a state,
+// called from the frame callback
+void CoreRewindOnFrame(void);
+
+#endif // CORE_INTERNAL
+
+// returns whether rewind is
+// available for the current emulation
+bool CoreIsRewindEnabled(void);
+
+// sets whether emulation is being rewound,
+// while rewinding a captured state is restored
+// every frame, starting at the most recent one
+void CoreSetRewinding(bool rewinding);
+
+// returns whether emulation is being rewound
+bool CoreIsRewinding(void);
+
+#endif // CORE_REWIND_HPP
@@ -7,6 +7,7 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
+#define CORE_INTERNAL
 #include "Rom.hpp"
 #include "Error.hpp"
 #include "m64p/Api.hpp"
@@ -221,6 +222,20 @@ static bool read_raw_file(std::string file, char** buf, int* size)
     return true;
 }
 
+//
+// Internal Functions
+//
+
+bool CoreReadRomFile(std::string file, char** buf, int* size)
+{
+    if (file.ends_with(".zip"))
+    {
+        return read_zip_file(file, buf, size);
+    }
+
+    return read_raw_file(file, buf, size);
+}
+
 //
 // Exported Functions
 //
@@ -240,19 +255,9 @@ bool CoreOpenRom(std::string file)
         return false;
     }
 
-    if (file.ends_with(".zip"))
-    {
-        if (!read_zip_file(file, &buf, &buf_size))
-        {
-            return false;
-        }
-    }
-    else
+    if (!CoreReadRomFile(file, &buf, &buf_size))
     {
-        if (!read_raw_file(file, &buf, &buf_size))
-        {
-            return false;
-        }
+        return false;
     }
 
     ret = m64p::Core.DoCommand(M64CMD_ROM_OPEN, buf_size, buf);
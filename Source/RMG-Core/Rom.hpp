@@ -12,6 +12,12 @@
 
 #include <string>
 
+#ifdef CORE_INTERNAL
+// reads the given ROM file (or the first ROM in a zip file)
+// into a buffer allocated with malloc(), without touching the core
+bool CoreReadRomFile(std::string file, char** buf, int* size);
+#endif // CORE_INTERNAL
+
 // opens the given file as ROM
 bool CoreOpenRom(std::string file);
 
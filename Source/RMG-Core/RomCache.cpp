@@ -0,0 +1,265 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "RomCache.hpp"
+#include "Error.hpp"
+
+#include "m64p/Api.hpp"
+
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+//
+// Local Defines
+//
+
+#define ROM_CACHE_FILE_NAME "RMG-RomCache.cache"
+#define ROM_CACHE_FIELDS    12
+
+//
+// Local Structures
+//
+
+struct l_RomCacheEntry
+{
+    uintmax_t       FileSize;
+    int64_t         FileTime;
+    CoreRomHeader   Header;
+    CoreRomSettings Settings;
+};
+
+//
+// Local Variables
+//
+
+static std::unordered_map<std::string, l_RomCacheEntry> l_RomCache;
+static bool                                             l_RomCacheLoaded = false;
+static bool                                             l_RomCacheChanged = false;
+static std::mutex                                       l_RomCacheMutex;
+
+//
+// Local Functions
+//
+
+static std::filesystem::path get_cache_file_path(void)
+{
+    const char* cachePath = m64p::Config.GetUserCachePath();
+    if (cachePath == nullptr)
+    {
+        return std::filesystem::path();
+    }
+
+    return std::filesystem::path(cachePath) / ROM_CACHE_FILE_NAME;
+}
+
+static bool get_file_info(std::string file, uintmax_t& fileSize, int64_t& fileTime)
+{
+    std::error_code errorCode;
+
+    fileSize = std::filesystem::file_size(file, errorCode);
+    if (errorCode)
+    {
+        return false;
+    }
+
+    fileTime = std::filesystem::last_write_time(file, errorCode).time_since_epoch().count();
+    return !errorCode;
+}
+
+template <typename T>
+static bool parse_number(const std::string& str, T& value)
+{
+    auto result = std::from_chars(str.data(), str.data() + str.size(), value);
+    return result.ec == std::errc() && result.ptr == str.data() + str.size();
+}
+
+// strings containing separators can't be stored
+static bool is_valid_string(const std::string& str)
+{
+    return str.find_first_of("\t\n") == std::string::npos;
+}
+
+static void rom_cache_read(void)
+{
+    std::ifstream stream(get_cache_file_path(), std::ios::binary);
+    std::string line;
+
+    while (std::getline(stream, line))
+    {
+        std::vector<std::string> fields;
+        size_t start = 0;
+        size_t end;
+
+        while ((end = line.find('\t', start)) != std::string::npos)
+        {
+            fields.emplace_back(line.substr(start, end - start));
+            start = end + 1;
+        }
+        fields.emplace_back(line.substr(start));
+
+        if (fields.size() != ROM_CACHE_FIELDS)
+        { // skip invalid entry
+            continue;
+        }
+
+        l_RomCacheEntry entry;
+        int disableExtraMem;
+
+        entry.Header.Name = fields[5];
+        entry.Settings.GoodName = fields[6];
+        entry.Settings.MD5 = fields[7];
+
+        if (!parse_number(fields[1], entry.FileSize) ||
+            !parse_number(fields[2], entry.FileTime) ||
+            !parse_number(fields[3], entry.Header.CRC1) ||
+            !parse_number(fields[4], entry.Header.CRC2) ||
+            !parse_number(fields[8], entry.Settings.SaveType) ||
+            !parse_number(fields[9], disableExtraMem) ||
+            !parse_number(fields[10], entry.Settings.CountPerOp) ||
+            !parse_number(fields[11], entry.Settings.SiDMADuration))
+        { // skip invalid entry
+            continue;
+        }
+
+        entry.Settings.DisableExtraMem = disableExtraMem != 0;
+        l_RomCache[fields[0]] = entry;
+    }
+
+    l_RomCacheLoaded = true;
+}
+
+//
+// Exported Functions
+//
+
+bool CoreGetCachedRomHeaderAndSettings(std::string file, CoreRomHeader& header, CoreRomSettings& settings)
+{
+    std::lock_guard<std::mutex> lock(l_RomCacheMutex);
+    uintmax_t fileSize;
+    int64_t   fileTime;
+
+    if (!l_RomCacheLoaded)
+    {
+        rom_cache_read();
+    }
+
+    auto iter = l_RomCache.find(file);
+    if (iter == l_RomCache.end())
+    {
+        return false;
+    }
+
+    // make sure the file hasn't changed
+    if (!get_file_info(file, fileSize, fileTime) ||
+        iter->second.FileSize != fileSize ||
+        iter->second.FileTime != fileTime)
+    {
+        l_RomCache.erase(iter);
+        l_RomCacheChanged = true;
+        return false;
+    }
+
+    header = iter->second.Header;
+    settings = iter->second.Settings;
+    return true;
+}
+
+bool CoreAddCachedRomHeaderAndSettings(std::string file, CoreRomHeader header, CoreRomSettings settings)
+{
+    std::lock_guard<std::mutex> lock(l_RomCacheMutex);
+    l_RomCacheEntry entry;
+
+    if (!is_valid_string(file) ||
+        !is_valid_string(header.Name) ||
+        !is_valid_string(settings.GoodName) ||
+        !is_valid_string(settings.MD5))
+    {
+        return false;
+    }
+
+    if (!get_file_info(file, entry.FileSize, entry.FileTime))
+    {
+        return false;
+    }
+
+    entry.Header = header;
+    entry.Settings = settings;
+
+    l_RomCache[file] = entry;
+    l_RomCacheChanged = true;
+    return true;
+}
+
+bool CoreSaveRomHeaderAndSettingsCache(void)
+{
+    std::lock_guard<std::mutex> lock(l_RomCacheMutex);
+    std::string error;
+    std::error_code errorCode;
+
+    if (!l_RomCacheChanged)
+    {
+        return true;
+    }
+
+    std::filesystem::path filePath = get_cache_file_path();
+    std::filesystem::path tmpFilePath = filePath;
+    tmpFilePath += ".tmp";
+
+    std::ofstream stream(tmpFilePath, std::ios::binary | std::ios::trunc);
+    if (!stream.is_open())
+    {
+        error = "CoreSaveRomHeaderAndSettingsCache Failed: cannot open ";
+        error += tmpFilePath.string();
+        CoreSetError(error);
+        return false;
+    }
+
+    for (const auto& entry : l_RomCache)
+    {
+        stream << entry.first << '\t'
+               << entry.second.FileSize << '\t'
+               << entry.second.FileTime << '\t'
+               << entry.second.Header.CRC1 << '\t'
+               << entry.second.Header.CRC2 << '\t'
+               << entry.second.Header.Name << '\t'
+               << entry.second.Settings.GoodName << '\t'
+               << entry.second.Settings.MD5 << '\t'
+               << entry.second.Settings.SaveType << '\t'
+               << (int)entry.second.Settings.DisableExtraMem << '\t'
+               << entry.second.Settings.CountPerOp << '\t'
+               << entry.second.Settings.SiDMADuration << '\n';
+    }
+
+    stream.close();
+    if (stream.fail())
+    {
+        error = "CoreSaveRomHeaderAndSettingsCache Failed: cannot write ";
+        error += tmpFilePath.string();
+        CoreSetError(error);
+        std::filesystem::remove(tmpFilePath, errorCode);
+        return false;
+    }
+
+    std::filesystem::rename(tmpFilePath, filePath, errorCode);
+    if (errorCode)
+    {
+        error = "CoreSaveRomHeaderAndSettingsCache std::filesystem::rename Failed: ";
+        error += errorCode.message();
+        CoreSetError(error);
+        std::filesystem::remove(tmpFilePath, errorCode);
+        return false;
+    }
+
+    l_RomCacheChanged = false;
+    return true;
+}
@@ -0,0 +1,28 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_ROMCACHE_HPP
+#define CORE_ROMCACHE_HPP
+
+#include "RomHeader.hpp"
+#include "RomSettings.hpp"
+
+#include <string>
+
+// retrieves the cached header and settings of the ROM,
+// returns false when it isn't cached or when the file has changed
+bool CoreGetCachedRomHeaderAndSettings(std::string file, CoreRomHeader& header, CoreRomSettings& settings);
+
+// adds the header and settings of the ROM to the cache
+bool CoreAddCachedRomHeaderAndSettings(std::string file, CoreRomHeader header, CoreRomSettings settings);
+
+// saves the ROM cache to file
+bool CoreSaveRomHeaderAndSettingsCache(void);
+
+#endif // CORE_ROMCACHE_HPP
@@ -0,0 +1,446 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#define CORE_INTERNAL
+#include "RomInspect.hpp"
+#include "m64p/Api.hpp"
+#include "Error.hpp"
+#include "Rom.hpp"
+
+#include <unordered_map>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <utility>
+#include <cctype>
+#include <mutex>
+
+//
+// Local Defines
+//
+
+#define ROM_DATABASE_FILE "mupen64plus.ini"
+
+// the defaults the core uses for
+// ROMs which aren't in its database
+#define ROM_DEFAULT_SAVETYPE        0 /* EEPROM 4KB */
+#define ROM_DEFAULT_COUNTPEROP      2
+#define ROM_DEFAULT_SIDMADURATION   0x900
+
+// limits how many RefMD5 entries are followed
+#define ROM_DATABASE_MAX_REFS 4
+
+//
+// Local Structures
+//
+
+using l_RomDatabaseEntry = std::unordered_map<std::string, std::string>;
+
+//
+// Local Variables
+//
+
+static std::unordered_map<std::string, l_RomDatabaseEntry> l_RomDatabase;
+// maps "CRC1 CRC2" to the MD5 of the entry
+static std::unordered_map<std::string, std::string>        l_RomDatabaseCrc;
+// path of the loaded database
+static std::string                                         l_RomDatabaseFile;
+static std::mutex                                          l_RomDatabaseMutex;
+
+static const uint32_t l_Md5Shifts[64] =
+{
+    7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+    5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+    4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+    6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+};
+
+static const uint32_t l_Md5Constants[64] =
+{
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+//
+// Local Functions
+//
+
+static uint32_t md5_read_le32(const uint8_t* data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static void md5_process_block(uint32_t state[4], const uint8_t* block)
+{
+    uint32_t words[16];
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+
+    for (int i = 0; i < 16; i++)
+    {
+        words[i] = md5_read_le32(block + (i * 4));
+    }
+
+    for (int i = 0; i < 64; i++)
+    {
+        uint32_t f;
+        int      g;
+
+        if (i < 16)
+        {
+            f = (b & c) | (~b & d);
+            g = i;
+        }
+        else if (i < 32)
+        {
+            f = (d & b) | (~d & c);
+            g = ((5 * i) + 1) % 16;
+        }
+        else if (i < 48)
+        {
+            f = b ^ c ^ d;
+            g = ((3 * i) + 5) % 16;
+        }
+        else
+        {
+            f = c ^ (b | ~d);
+            g = (7 * i) % 16;
+        }
+
+        f += a + l_Md5Constants[i] + words[g];
+        a = d;
+        d = c;
+        c = b;
+        b += (f << l_Md5Shifts[i]) | (f >> (32 - l_Md5Shifts[i]));
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+}
+
+// returns the MD5 of data as uppercase hex string,
+// which is the format the core's database uses
+static std::string md5_hash(const uint8_t* data, size_t size)
+{
+    uint32_t state[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+    uint8_t  block[64];
+    size_t   offset = 0;
+    uint64_t bits = (uint64_t)size * 8;
+    char     hash[33];
+
+    for (; offset + 64 <= size; offset += 64)
+    {
+        md5_process_block(state, data + offset);
+    }
+
+    // pad the remaining data with 0x80, zeroes
+    // and the length in bits, which may need an
+    // extra block when it doesn't fit anymore
+    size_t remaining = size - offset;
+    memset(block, 0, sizeof(block));
+    memcpy(block, data + offset, remaining);
+    block[remaining] = 0x80;
+
+    if (remaining >= 56)
+    {
+        md5_process_block(state, block);
+        memset(block, 0, sizeof(block));
+    }
+
+    for (int i = 0; i < 8; i++)
+    {
+        block[56 + i] = (uint8_t)(bits >> (i * 8));
+    }
+    md5_process_block(state, block);
+
+    for (int i = 0; i < 16; i++)
+    {
+        snprintf(hash + (i * 2), 3, "%02X", (state[i / 4] >> ((i % 4) * 8)) & 0xFF);
+    }
+
+    return std::string(hash, 32);
+}
+
+// converts the ROM to big endian (.z64) byte order,
+// returns false when it isn't a valid ROM image
+static bool rom_to_big_endian(uint8_t* data, int size)
+{
+    if (size < (int)sizeof(m64p_rom_header))
+    {
+        return false;
+    }
+
+    if (data[0] == 0x80 && data[1] == 0x37 && data[2] == 0x12 && data[3] == 0x40)
+    { // .z64
+        return true;
+    }
+    else if (data[0] == 0x37 && data[1] == 0x80 && data[2] == 0x40 && data[3] == 0x12)
+    { // .v64
+        for (int i = 0; i + 1 < size; i += 2)
+        {
+            std::swap(data[i], data[i + 1]);
+        }
+        return true;
+    }
+    else if (data[0] == 0x40 && data[1] == 0x12 && data[2] == 0x37 && data[3] == 0x80)
+    { // .n64
+        for (int i = 0; i + 3 < size; i += 4)
+        {
+            std::swap(data[i], data[i + 3]);
+            std::swap(data[i + 1], data[i + 2]);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+static std::string trim(std::string str)
+{
+    const char* whitespace = " \t\r\n";
+
+    size_t start = str.find_first_not_of(whitespace);
+    if (start == std::string::npos)
+    {
+        return std::string();
+    }
+
+    size_t end = str.find_last_not_of(whitespace);
+    return str.substr(start, end - start + 1);
+}
+
+// parses the core's ROM database, it's only parsed
+// again when it's given at a different path,
+// l_RomDatabaseMutex must be locked
+static void rom_database_load(const std::string& file)
+{
+    std::ifstream stream;
+    std::string   line;
+    std::string   md5;
+
+    if (l_RomDatabaseFile == file)
+    {
+        return;
+    }
+
+    l_RomDatabaseFile = file;
+    l_RomDatabase.clear();
+    l_RomDatabaseCrc.clear();
+
+    if (l_RomDatabaseFile.empty())
+    {
+        return;
+    }
+
+    stream.open(l_RomDatabaseFile);
+    if (!stream.is_open())
+    {
+        return;
+    }
+
+    while (std::getline(stream, line))
+    {
+        line = trim(line);
+        if (line.empty() || line[0] == ';' || line[0] == '#')
+        {
+            continue;
+        }
+
+        if (line.front() == '[' && line.back() == ']')
+        {
+            md5 = line.substr(1, line.size() - 2);
+            // the database should contain uppercase
+            // MD5s, but normalize them to be sure
+            for (char& c : md5)
+            {
+                c = toupper((unsigned char)c);
+            }
+            continue;
+        }
+
+        size_t separator = line.find('=');
+        if (md5.empty() || separator == std::string::npos)
+        {
+            continue;
+        }
+
+        std::string key   = trim(line.substr(0, separator));
+        std::string value = trim(line.substr(separator + 1));
+
+        if (key == "CRC")
+        {
+            l_RomDatabaseCrc.try_emplace(value, md5);
+        }
+
+        l_RomDatabase[md5][key] = value;
+    }
+}
+
+// retrieves the database value of the entry,
+// entries can inherit values using RefMD5
+static bool rom_database_get_value(const l_RomDatabaseEntry* entry, std::string key, std::string& value)
+{
+    for (int i = 0; i < ROM_DATABASE_MAX_REFS && entry != nullptr; i++)
+    {
+        auto iter = entry->find(key);
+        if (iter != entry->end())
+        {
+            value = iter->second;
+            return true;
+        }
+
+        iter = entry->find("RefMD5");
+        if (iter == entry->end())
+        {
+            break;
+        }
+
+        auto refIter = l_RomDatabase.find(iter->second);
+        entry = (refIter == l_RomDatabase.end()) ? nullptr : &refIter->second;
+    }
+
+    return false;
+}
+
+static int rom_database_get_int(const l_RomDatabaseEntry* entry, std::string key, int defaultValue)
+{
+    std::string value;
+
+    if (!rom_database_get_value(entry, key, value))
+    {
+        return defaultValue;
+    }
+
+    try
+    {
+        return std::stoi(value);
+    }
+    catch (...)
+    {
+        return defaultValue;
+    }
+}
+
+static uint16_t rom_database_get_savetype(const l_RomDatabaseEntry* entry)
+{
+    static const char* saveTypes[] =
+    {
+        "Eeprom 4KB",
+        "Eeprom 16KB",
+        "SRAM",
+        "Flash RAM",
+        "Controller Pack",
+        "None"
+    };
+
+    std::string value;
+
+    if (rom_database_get_value(entry, "SaveType", value))
+    {
+        for (uint16_t i = 0; i < (sizeof(saveTypes) / sizeof(saveTypes[0])); i++)
+        {
+            if (value == saveTypes[i])
+            {
+                return i;
+            }
+        }
+    }
+
+    return ROM_DEFAULT_SAVETYPE;
+}
+
+//
+// Exported Functions
+//
+
+std::string CoreGetRomDatabaseFile(void)
+{
+    const char* file = nullptr;
+
+    if (m64p::Config.IsHooked())
+    {
+        file = m64p::Config.GetSharedDataFilepath(ROM_DATABASE_FILE);
+    }
+
+    return file != nullptr ? std::string(file) : std::string();
+}
+
+bool CoreInspectRom(std::string file, std::string databaseFile, CoreRomHeader& header, CoreRomSettings& settings)
+{
+    m64p_rom_header romHeader;
+    char*           buf;
+    int             buf_size;
+    char            crc[18];
+
+    if (!CoreReadRomFile(file, &buf, &buf_size))
+    {
+        return false;
+    }
+
+    if (!rom_to_big_endian((uint8_t*)buf, buf_size))
+    {
+        free(buf);
+        CoreSetError("CoreInspectRom Failed: file isn't a valid ROM image!");
+        return false;
+    }
+
+    // the core doesn't convert the header fields,
+    // so neither do we, this keeps them identical
+    memcpy(&romHeader, buf, sizeof(m64p_rom_header));
+    settings.MD5 = md5_hash((const uint8_t*)buf, buf_size);
+    free(buf);
+
+    header.CRC1 = romHeader.CRC1;
+    header.CRC2 = romHeader.CRC2;
+    header.Name = std::string((char*)romHeader.Name, strnlen((char*)romHeader.Name, sizeof(romHeader.Name)));
+
+    std::lock_guard<std::mutex> lock(l_RomDatabaseMutex);
+    rom_database_load(databaseFile);
+
+    // look the ROM up by MD5 first,
+    // and fallback to the CRCs
+    const l_RomDatabaseEntry* entry = nullptr;
+    auto iter = l_RomDatabase.find(settings.MD5);
+    if (iter == l_RomDatabase.end())
+    {
+        const uint8_t* crc1 = (const uint8_t*)&romHeader.CRC1;
+        const uint8_t* crc2 = (const uint8_t*)&romHeader.CRC2;
+        snprintf(crc, sizeof(crc), "%02X%02X%02X%02X %02X%02X%02X%02X",
+                    crc1[0], crc1[1], crc1[2], crc1[3],
+                    crc2[0], crc2[1], crc2[2], crc2[3]);
+
+        auto crcIter = l_RomDatabaseCrc.find(crc);
+        if (crcIter != l_RomDatabaseCrc.end())
+        {
+            iter = l_RomDatabase.find(crcIter->second);
+        }
+    }
+    if (iter != l_RomDatabase.end())
+    {
+        entry = &iter->second;
+    }
+
+    if (entry == nullptr || !rom_database_get_value(entry, "GoodName", settings.GoodName))
+    {
+        settings.GoodName = trim(header.Name) + " (unknown rom)";
+    }
+
+    settings.SaveType        = rom_database_get_savetype(entry);
+    settings.DisableExtraMem = rom_database_get_int(entry, "DisableExtraMem", 0) != 0;
+    settings.CountPerOp      = rom_database_get_int(entry, "CountPerOp", ROM_DEFAULT_COUNTPEROP);
+    settings.SiDMADuration   = rom_database_get_int(entry, "SiDmaDuration", ROM_DEFAULT_SIDMADURATION);
+    return true;
+}
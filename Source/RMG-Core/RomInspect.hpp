@@ -0,0 +1,30 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_ROMINSPECT_HPP
+#define CORE_ROMINSPECT_HPP
+
+#include "RomHeader.hpp"
+#include "RomSettings.hpp"
+
+#include <string>
+
+// returns the path of the core's ROM database (mupen64plus.ini),
+// or an empty string when it can't be found, this uses the
+// core's config, so call it on the GUI thread
+std::string CoreGetRomDatabaseFile(void);
+
+// retrieves the header and settings of the ROM
+// without opening it in the core, the settings are
+// looked up in databaseFile which should be retrieved
+// with CoreGetRomDatabaseFile(), safe to call from
+// any thread and while emulation is running
+bool CoreInspectRom(std::string file, std::string databaseFile, CoreRomHeader& header, CoreRomSettings& settings);
+
+#endif // CORE_ROMINSPECT_HPP
@@ -0,0 +1,178 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#define CORE_INTERNAL
+#include "RunAhead.hpp"
+#include "Settings/Settings.hpp"
+#include "RomSettings.hpp"
+#include "VidExt.hpp"
+#include "SaveState.hpp"
+#include "Plugins.hpp"
+#include "Rewind.hpp"
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+//
+// Local Defines
+//
+
+#define RUNAHEAD_MAX_FRAMES 4
+
+//
+// Local Variables
+//
+
+static std::atomic<int>  l_RunAheadFrames = 0;
+static std::atomic<bool> l_FrameHidden = false;
+
+// only used on the emulation thread
+static int                  l_Phase = 0;
+static bool                 l_HasState = false;
+static bool                 l_CanDiscardAudio = false;
+static bool                 l_AudioDiscarded = false;
+static std::vector<uint8_t> l_StateBuffer;
+
+//
+// Local Functions
+//
+
+// sets which output of the next frame is used,
+// speculative frames don't output anything
+static void set_frame_output(bool video, bool audio)
+{
+    l_FrameHidden = !video;
+
+    if (l_CanDiscardAudio && l_AudioDiscarded == audio)
+    {
+        l_AudioDiscarded = !audio;
+        CorePluginsSetAudioDiscard(l_AudioDiscarded);
+    }
+}
+
+//
+// Internal Functions
+//
+
+void CoreRunAheadStart(void)
+{
+    CoreRomSettings romSettings;
+    int frames;
+
+    CoreRunAheadStop();
+
+    // the speculative frames can only be hidden
+    // when the video extension has been set up
+    if (!CoreSupportsSaveStateBuffers() ||
+        !CoreIsVidExtSetup() ||
+        !CoreGetCurrentDefaultRomSettings(romSettings))
+    {
+        return;
+    }
+
+    frames = CoreSettingsGetIntValue(SettingsID::Game_RunAheadFrames, romSettings.MD5);
+    frames = std::clamp(frames, 0, RUNAHEAD_MAX_FRAMES);
+    if (frames == 0)
+    {
+        return;
+    }
+
+    // without discarding, the audio of the
+    // speculative frames is played as well
+    l_CanDiscardAudio = CorePluginsSetAudioDiscard(false);
+    l_AudioDiscarded = false;
+
+    l_Phase = 0;
+    l_HasState = false;
+    l_RunAheadFrames = frames;
+    set_frame_output(false, true);
+}
+
+void CoreRunAheadStop(void)
+{
+    if (l_RunAheadFrames == 0)
+    {
+        return;
+    }
+
+    l_RunAheadFrames = 0;
+    set_frame_output(true, true);
+
+    // free the state buffer
+    std::vector<uint8_t>().swap(l_StateBuffer);
+    l_HasState = false;
+}
+
+bool CoreRunAheadOnFrame(void)
+{
+    int frames = l_RunAheadFrames;
+
+    if (frames == 0)
+    {
+        return true;
+    }
+
+    // rewinding restores states itself, so
+    // only emulate real frames while rewinding
+    if (CoreIsRewinding())
+    {
+        l_Phase = 0;
+        set_frame_output(true, true);
+        return true;
+    }
+
+    // a cycle consists of the real frame, which only
+    // outputs audio, followed by the speculative frames
+    // of which only the last one outputs video,
+    // afterwards the state after the real frame
+    // is restored, so the speculative frames are undone
+    if (l_Phase == 0)
+    {
+        l_HasState = CoreSaveStateToBuffer(l_StateBuffer);
+        if (!l_HasState)
+        { // emulate without run-ahead
+            set_frame_output(true, true);
+            return true;
+        }
+
+        l_Phase = 1;
+        set_frame_output(l_Phase == frames, false);
+        return true;
+    }
+
+    if (l_Phase < frames)
+    {
+        l_Phase++;
+        set_frame_output(l_Phase == frames, false);
+        return false;
+    }
+
+    // last speculative frame has been shown
+    CoreLoadStateFromBuffer(l_StateBuffer);
+    l_Phase = 0;
+    set_frame_output(false, true);
+    return false;
+}
+
+bool CoreRunAheadIsFrameHidden(void)
+{
+    return l_FrameHidden;
+}
+
+//
+// Exported Functions
+//
+
+int CoreGetRunAheadFrames(void)
+{
+    return l_RunAheadFrames;
+}
@@ -0,0 +1,38 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_RUNAHEAD_HPP
+#define CORE_RUNAHEAD_HPP
+
+// internal run-ahead functions
+#ifdef CORE_INTERNAL
+
+// starts run-ahead when it's enabled for
+// the opened ROM, called before emulation starts
+void CoreRunAheadStart(void);
+
+// stops run-ahead, called after emulation stopped
+void CoreRunAheadStop(void);
+
+// advances run-ahead to the next frame, called from
+// the frame callback, returns false when the frame
+// was a speculative frame which has been undone
+bool CoreRunAheadOnFrame(void);
+
+// returns whether the video output
+// of the current frame should be skipped
+bool CoreRunAheadIsFrameHidden(void);
+
+#endif // CORE_INTERNAL
+
+// returns the amount of frames emulated
+// ahead, returns 0 when run-ahead is disabled
+int CoreGetRunAheadFrames(void);
+
+#endif // CORE_RUNAHEAD_HPP
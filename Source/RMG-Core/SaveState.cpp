@@ -7,11 +7,359 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
+#define CORE_INTERNAL
 #include "SaveState.hpp"
+#include "Emulation.hpp"
+#include "Settings/Settings.hpp"
+#include "RomSettings.hpp"
+#include "Callback.hpp"
 #include "Error.hpp"
 
 #include "m64p/Api.hpp"
 
+#include <zlib.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif // _WIN32
+
+//
+// Local Structures
+//
+
+struct l_SaveStateRequest
+{
+    std::filesystem::path File;
+    std::vector<uint8_t>  State;
+};
+
+struct l_SaveStateWriter
+{
+    std::thread thread;
+    std::condition_variable condition;
+    std::deque<l_SaveStateRequest> requests;
+    bool busy = false;
+    bool stop = false;
+
+    ~l_SaveStateWriter(void);
+};
+
+//
+// Local Variables
+//
+
+static CoreSaveStateBufferStats l_SaveStateBufferStats;
+static std::mutex               l_SaveStateBufferStatsMutex;
+
+// file of the save state which will
+// be captured at the end of the frame
+static std::filesystem::path l_CaptureFile;
+static bool                  l_CaptureRequested = false;
+static std::mutex            l_CaptureMutex;
+
+static std::mutex        l_WriterMutex;
+static l_SaveStateWriter l_Writer;
+
+// errors are stored per thread, so the error of
+// a failed background save is kept here for the
+// thread which handles SaveStateComplete
+static std::string l_SaveStateError;
+static std::mutex  l_SaveStateErrorMutex;
+
+//
+// Local Functions
+//
+
+static int64_t get_elapsed_microseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+l_SaveStateWriter::~l_SaveStateWriter(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(l_WriterMutex);
+        this->stop = true;
+        this->condition.notify_all();
+    }
+
+    if (this->thread.joinable())
+    {
+        this->thread.join();
+    }
+}
+
+// returns the file of the current slot, RMG names the
+// slot files itself, so slot saves can be written in the
+// background and slot loads always find the same file
+static std::filesystem::path get_save_state_slot_file(void)
+{
+    CoreRomSettings romSettings;
+    std::string fileName;
+    int slot;
+
+    slot = CoreGetSaveStateSlot();
+    if (slot < 0 || !CoreGetCurrentRomSettings(romSettings))
+    {
+        return std::filesystem::path();
+    }
+
+    // the good name may contain characters
+    // which aren't allowed in file names
+    fileName = romSettings.GoodName;
+    for (char& c : fileName)
+    {
+        if (std::string_view("<>:\"/\\|?*").find(c) != std::string_view::npos)
+        {
+            c = '_';
+        }
+    }
+
+    std::filesystem::path file = CoreSettingsGetStringValue(SettingsID::Core_SaveStatePath);
+    file /= fileName + ".st" + std::to_string(slot);
+    return file;
+}
+
+static void save_state_clear_error(void)
+{
+    std::lock_guard<std::mutex> lock(l_SaveStateErrorMutex);
+    l_SaveStateError.clear();
+}
+
+// reports completion of a background save,
+// the error is kept when it failed, so the
+// thread handling SaveStateComplete can show it
+static void save_state_complete(bool ret)
+{
+    if (!ret)
+    {
+        std::lock_guard<std::mutex> lock(l_SaveStateErrorMutex);
+        l_SaveStateError = CoreGetError();
+    }
+
+    CoreStateCallback(nullptr, M64CORE_STATE_SAVECOMPLETE, ret ? 1 : 0);
+}
+
+// compresses the state with gzip like the core does,
+// so the file can be loaded with CoreLoadSaveState()
+static bool compress_save_state(const std::vector<uint8_t>& state, std::vector<uint8_t>& output)
+{
+    z_stream stream = {};
+    int ret;
+
+    // 15 + 16 selects the gzip format
+    if (deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        return false;
+    }
+
+    output.resize(deflateBound(&stream, state.size()));
+
+    stream.next_in = (Bytef*)state.data();
+    stream.avail_in = state.size();
+    stream.next_out = output.data();
+    stream.avail_out = output.size();
+
+    ret = deflate(&stream, Z_FINISH);
+    output.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    return ret == Z_STREAM_END;
+}
+
+// writes the file and makes sure it's on disk before
+// it replaces the old file, so a crash can't leave
+// a partially written save state behind
+static bool write_save_state_file(const std::filesystem::path& file, const std::vector<uint8_t>& data)
+{
+    std::string error;
+    std::error_code errorCode;
+    std::filesystem::path tmpFile = file;
+    tmpFile += ".tmp";
+    bool ret;
+
+    if (file.has_parent_path())
+    {
+        std::filesystem::create_directories(file.parent_path(), errorCode);
+    }
+
+    FILE* fileHandle = std::fopen(tmpFile.string().c_str(), "wb");
+    if (fileHandle == nullptr)
+    {
+        error = "write_save_state_file Failed: cannot open ";
+        error += tmpFile.string();
+        CoreSetError(error);
+        return false;
+    }
+
+    ret = std::fwrite(data.data(), 1, data.size(), fileHandle) == data.size() &&
+          std::fflush(fileHandle) == 0;
+#ifdef _WIN32
+    ret = ret && _commit(_fileno(fileHandle)) == 0;
+#else
+    ret = ret && fsync(fileno(fileHandle)) == 0;
+#endif // _WIN32
+    ret = (std::fclose(fileHandle) == 0) && ret;
+
+    if (!ret)
+    {
+        error = "write_save_state_file Failed: cannot write ";
+        error += tmpFile.string();
+        CoreSetError(error);
+        std::filesystem::remove(tmpFile, errorCode);
+        return false;
+    }
+
+    std::filesystem::rename(tmpFile, file, errorCode);
+    if (errorCode)
+    {
+        error = "write_save_state_file std::filesystem::rename Failed: ";
+        error += errorCode.message();
+        CoreSetError(error);
+        std::filesystem::remove(tmpFile, errorCode);
+        return false;
+    }
+
+    return true;
+}
+
+static void save_state_writer_thread(void)
+{
+    std::unique_lock<std::mutex> lock(l_WriterMutex);
+    std::vector<uint8_t> compressedState;
+
+    while (true)
+    {
+        l_Writer.condition.wait(lock, []
+        {
+            return !l_Writer.requests.empty() || l_Writer.stop;
+        });
+
+        // finish writing the
+        // pending states first
+        if (l_Writer.requests.empty())
+        {
+            break;
+        }
+
+        l_SaveStateRequest request = std::move(l_Writer.requests.front());
+        l_Writer.requests.pop_front();
+        l_Writer.busy = true;
+        lock.unlock();
+
+        bool ret = compress_save_state(request.State, compressedState);
+        if (!ret)
+        {
+            CoreSetError("save_state_writer_thread Failed: cannot compress save state!");
+        }
+        ret = ret && write_save_state_file(request.File, compressedState);
+        save_state_complete(ret);
+
+        lock.lock();
+        l_Writer.busy = false;
+        l_Writer.condition.notify_all();
+    }
+}
+
+// captures the state and queues it for writing
+static bool save_state_write_behind(std::filesystem::path file)
+{
+    l_SaveStateRequest request;
+
+    if (!CoreSaveStateToBuffer(request.State))
+    {
+        return false;
+    }
+
+    request.File = file;
+
+    std::lock_guard<std::mutex> lock(l_WriterMutex);
+
+    if (!l_Writer.thread.joinable())
+    {
+        l_Writer.stop = false;
+        l_Writer.thread = std::thread(save_state_writer_thread);
+    }
+
+    l_Writer.requests.emplace_back(std::move(request));
+    l_Writer.condition.notify_all();
+    return true;
+}
+
+// saves the state in the background when possible,
+// when emulation is running the state is captured
+// at the end of the frame, else it's captured now
+static bool save_state_async(std::filesystem::path file)
+{
+    std::string error;
+
+    if (file.empty())
+    {
+        error = "CoreSaveState Failed: ";
+        error += "cannot determine save state file!";
+        CoreSetError(error);
+        return false;
+    }
+
+    if (CoreIsEmulationPaused())
+    {
+        return save_state_write_behind(file);
+    }
+
+    std::lock_guard<std::mutex> lock(l_CaptureMutex);
+    l_CaptureFile = file;
+    l_CaptureRequested = true;
+    return true;
+}
+
+//
+// Internal Functions
+//
+
+void CoreSaveStateOnFrame(void)
+{
+    std::filesystem::path file;
+
+    {
+        std::lock_guard<std::mutex> lock(l_CaptureMutex);
+        if (!l_CaptureRequested)
+        {
+            return;
+        }
+
+        file = l_CaptureFile;
+        l_CaptureRequested = false;
+    }
+
+    if (!save_state_write_behind(file))
+    {
+        save_state_complete(false);
+    }
+}
+
+void CoreSaveStateCancel(void)
+{
+    std::lock_guard<std::mutex> lock(l_CaptureMutex);
+
+    if (l_CaptureRequested)
+    {
+        l_CaptureRequested = false;
+        CoreSetError("CoreSaveState Failed: emulation stopped before the state was captured!");
+        save_state_complete(false);
+    }
+}
+
 //
 // Exported Functions
 //
@@ -38,6 +386,11 @@ int CoreGetSaveStateSlot(void)
     m64p_error ret;
     int slot = -1;
 
+    if (CoreGetCachedState(CoreStateCallbackType::SaveStateSlot, slot))
+    {
+        return slot;
+    }
+
     ret = m64p::Core.DoCommand(M64CMD_CORE_STATE_QUERY, M64CORE_SAVESTATE_SLOT, &slot);
     if (ret != M64ERR_SUCCESS)
     {
@@ -50,11 +403,41 @@ int CoreGetSaveStateSlot(void)
 }
 
 bool CoreSaveState(void)
+{
+    std::filesystem::path file = get_save_state_slot_file();
+
+    if (file.empty())
+    {
+        save_state_clear_error();
+        CoreSetError("CoreSaveState Failed: cannot determine save state file!");
+        return false;
+    }
+
+    return CoreSaveState(file.string());
+}
+
+bool CoreSaveState(std::string file)
 {
     std::string error;
+    std::error_code errorCode;
     m64p_error ret;
 
-    ret = m64p::Core.DoCommand(M64CMD_STATE_SAVE, 0, nullptr);
+    save_state_clear_error();
+
+    if (CoreSupportsSaveStateBuffers() &&
+        (CoreIsEmulationRunning() || CoreIsEmulationPaused()))
+    {
+        return save_state_async(file);
+    }
+
+    // the core doesn't create the directory
+    std::filesystem::path path = file;
+    if (path.has_parent_path())
+    {
+        std::filesystem::create_directories(path.parent_path(), errorCode);
+    }
+
+    ret = m64p::Core.DoCommand(M64CMD_STATE_SAVE, 1, (void*)file.c_str());
     if (ret != M64ERR_SUCCESS)
     {
         error = "CoreSaveState: m64p::Core.DoCommand(M64CMD_STATE_SAVE) Failed: ";
@@ -65,15 +448,33 @@ bool CoreSaveState(void)
     return ret == M64ERR_SUCCESS;
 }
 
-bool CoreSaveState(std::string file)
+bool CoreLoadSaveState(void)
+{
+    std::filesystem::path file = get_save_state_slot_file();
+
+    if (file.empty())
+    {
+        CoreSetError("CoreLoadSaveState Failed: cannot determine save state file!");
+        return false;
+    }
+
+    return CoreLoadSaveState(file.string());
+}
+
+bool CoreLoadSaveState(std::string file)
 {
     std::string error;
     m64p_error ret;
 
-    ret = m64p::Core.DoCommand(M64CMD_STATE_SAVE, 1, (void*)file.c_str());
+    // make sure a state which is still
+    // being written in the background
+    // is loaded instead of the old one
+    CoreSaveStateFlush();
+
+    ret = m64p::Core.DoCommand(M64CMD_STATE_LOAD, 0, (void*)file.c_str());
     if (ret != M64ERR_SUCCESS)
     {
-        error = "CoreSaveState: m64p::Core.DoCommand(M64CMD_STATE_SAVE) Failed: ";
+        error = "CoreLoadSaveState: m64p::Core.DoCommand(M64CMD_STATE_LOAD) Failed: ";
         error += m64p::Core.ErrorMessage(ret);
         CoreSetError(error);
     }
@@ -81,34 +482,108 @@ bool CoreSaveState(std::string file)
     return ret == M64ERR_SUCCESS;
 }
 
-bool CoreLoadSaveState(void)
+bool CoreSupportsSaveStateBuffers(void)
+{
+    return m64p::Core.SaveStateToMemory != nullptr &&
+           m64p::Core.LoadStateFromMemory != nullptr;
+}
+
+bool CoreSaveStateToBuffer(std::vector<uint8_t>& buffer)
 {
     std::string error;
     m64p_error ret;
+    size_t size;
+
+    if (!CoreSupportsSaveStateBuffers())
+    {
+        error = "CoreSaveStateToBuffer Failed: ";
+        error += "core doesn't support saving states in memory!";
+        CoreSetError(error);
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    // use the whole capacity of the buffer,
+    // when it's too small, the core returns
+    // the required size and we try again
+    buffer.resize(buffer.capacity());
+    size = buffer.size();
+
+    ret = m64p::Core.SaveStateToMemory(buffer.data(), &size);
+    if (ret == M64ERR_INPUT_INVALID && size > buffer.size())
+    {
+        buffer.resize(size);
+        ret = m64p::Core.SaveStateToMemory(buffer.data(), &size);
+    }
 
-    ret = m64p::Core.DoCommand(M64CMD_STATE_LOAD, 0, nullptr);
     if (ret != M64ERR_SUCCESS)
     {
-        error = "CoreLoadSaveState: m64p::Core.DoCommand(M64CMD_STATE_LOAD) Failed: ";
+        error = "CoreSaveStateToBuffer: m64p::Core.SaveStateToMemory() Failed: ";
         error += m64p::Core.ErrorMessage(ret);
         CoreSetError(error);
+        buffer.clear();
+        return false;
     }
 
-    return ret == M64ERR_SUCCESS;
+    buffer.resize(size);
+
+    std::lock_guard<std::mutex> lock(l_SaveStateBufferStatsMutex);
+    l_SaveStateBufferStats.Size = size;
+    l_SaveStateBufferStats.SaveTime = get_elapsed_microseconds(start);
+    return true;
 }
 
-bool CoreLoadSaveState(std::string file)
+bool CoreLoadStateFromBuffer(std::span<const uint8_t> buffer)
 {
     std::string error;
     m64p_error ret;
 
-    ret = m64p::Core.DoCommand(M64CMD_STATE_LOAD, 0, (void*)file.c_str());
+    if (!CoreSupportsSaveStateBuffers())
+    {
+        error = "CoreLoadStateFromBuffer Failed: ";
+        error += "core doesn't support loading states from memory!";
+        CoreSetError(error);
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    ret = m64p::Core.LoadStateFromMemory(buffer.data(), buffer.size());
     if (ret != M64ERR_SUCCESS)
     {
-        error = "CoreLoadSaveState: m64p::Core.DoCommand(M64CMD_STATE_LOAD) Failed: ";
+        error = "CoreLoadStateFromBuffer: m64p::Core.LoadStateFromMemory() Failed: ";
         error += m64p::Core.ErrorMessage(ret);
         CoreSetError(error);
+        return false;
     }
 
-    return ret == M64ERR_SUCCESS;
+    std::lock_guard<std::mutex> lock(l_SaveStateBufferStatsMutex);
+    l_SaveStateBufferStats.Size = buffer.size();
+    l_SaveStateBufferStats.LoadTime = get_elapsed_microseconds(start);
+    return true;
+}
+
+CoreSaveStateBufferStats CoreGetSaveStateBufferStats(void)
+{
+    std::lock_guard<std::mutex> lock(l_SaveStateBufferStatsMutex);
+    return l_SaveStateBufferStats;
+}
+
+std::string CoreGetSaveStateError(void)
+{
+    std::lock_guard<std::mutex> lock(l_SaveStateErrorMutex);
+    return l_SaveStateError;
+}
+
+bool CoreSaveStateFlush(void)
+{
+    std::unique_lock<std::mutex> lock(l_WriterMutex);
+
+    l_Writer.condition.wait(lock, []
+    {
+        return (l_Writer.requests.empty() && !l_Writer.busy) || !l_Writer.thread.joinable();
+    });
+
+    return true;
 }
@@ -10,7 +10,33 @@
 #ifndef CORE_SAVESTATE_HPP
 #define CORE_SAVESTATE_HPP
 
+#include <cstdint>
+#include <span>
 #include <string>
+#include <vector>
+
+struct CoreSaveStateBufferStats
+{
+    // size of the last state in bytes
+    size_t  Size = 0;
+    // duration of the last save and load in microseconds
+    int64_t SaveTime = 0;
+    int64_t LoadTime = 0;
+};
+
+// internal save state functions
+#ifdef CORE_INTERNAL
+
+// captures requested save state,
+// called from the frame callback
+void CoreSaveStateOnFrame(void);
+
+// drops the requested save state
+// which hasn't been captured yet,
+// called after emulation stopped
+void CoreSaveStateCancel(void);
+
+#endif // CORE_INTERNAL
 
 // sets save state slot
 bool CoreSetSaveStateSlot(int slot);
@@ -19,16 +45,50 @@ bool CoreSetSaveStateSlot(int slot);
 // returns -1 on error
 int  CoreGetSaveStateSlot(void);
 
-// saves state
+// saves state to the file of the current slot,
+// see CoreSaveState(std::string file)
 bool CoreSaveState(void);
 
-// saves state to file
+// saves state to file, when the core supports saving
+// states in memory the state is captured at the end
+// of the current frame and compressed and written
+// in the background, completion is reported with
+// CoreStateCallbackType::SaveStateComplete
 bool CoreSaveState(std::string file);
 
-// loads saved state
+// waits for pending save states to be written
+bool CoreSaveStateFlush(void);
+
+// retrieves the error of the last save state
+// which failed in the background, errors are
+// stored per thread, so CoreGetError() doesn't
+// return it when SaveStateComplete reports failure
+std::string CoreGetSaveStateError(void);
+
+// loads saved state from the file of the current slot
 bool CoreLoadSaveState(void);
 
 // loads saved state from file
 bool CoreLoadSaveState(std::string file);
 
-#endif // CORE_SAVESTATE_HPP
\ No newline at end of file
+// returns whether the core supports
+// saving and loading states in memory,
+// always false when RMG-Core is built
+// without USE_STATE_BUFFERS
+bool CoreSupportsSaveStateBuffers(void);
+
+// saves state to buffer without any file I/O,
+// the buffer's capacity is reused, so reusing the
+// same buffer avoids allocating, emulation must be
+// paused or it must be called from the frame callback
+bool CoreSaveStateToBuffer(std::vector<uint8_t>& buffer);
+
+// loads state from buffer, emulation must be paused
+// or it must be called from the frame callback
+bool CoreLoadStateFromBuffer(std::span<const uint8_t> buffer);
+
+// retrieves size and duration of the
+// last state saved or loaded in memory
+CoreSaveStateBufferStats CoreGetSaveStateBufferStats(void);
+
+#endif // CORE_SAVESTATE_HPP
@@ -0,0 +1,358 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "GameSettings.hpp"
+
+#include "Error.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+
+//
+// Local Defines
+//
+
+// the journal is compacted when it contains
+// more records than this minimum and twice
+// the amount of values stored
+#define JOURNAL_COMPACT_MIN_RECORDS 64
+
+#define JOURNAL_RECORD_SET    'S'
+#define JOURNAL_RECORD_DELETE 'D'
+
+//
+// Local Variables
+//
+
+static std::unordered_map<std::string, std::unordered_map<std::string, std::string>> l_gameSettings;
+static std::filesystem::path l_journalFile;
+static std::ofstream         l_journalStream;
+static int                   l_journalRecords = 0;
+static bool                  l_isOpen = false;
+static std::mutex            l_gameSettingsMutex;
+
+//
+// Local Functions
+//
+
+// escapes the characters which are
+// used as separators in the journal
+static std::string journal_escape(std::string str)
+{
+    std::string escaped;
+
+    for (char c : str)
+    {
+        switch (c)
+        {
+        default:
+            escaped += c;
+            break;
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '\t':
+            escaped += "\\t";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        }
+    }
+
+    return escaped;
+}
+
+static std::string journal_unescape(std::string str)
+{
+    std::string unescaped;
+
+    for (size_t i = 0; i < str.size(); i++)
+    {
+        if (str[i] != '\\' || i + 1 >= str.size())
+        {
+            unescaped += str[i];
+            continue;
+        }
+
+        i++;
+        switch (str[i])
+        {
+        default:
+            unescaped += str[i];
+            break;
+        case 't':
+            unescaped += '\t';
+            break;
+        case 'n':
+            unescaped += '\n';
+            break;
+        }
+    }
+
+    return unescaped;
+}
+
+static void journal_write_set(std::ostream& stream, const std::string& md5, const std::string& key, const std::string& value)
+{
+    stream << JOURNAL_RECORD_SET << '\t' << md5 << '\t' << journal_escape(key) << '\t' << journal_escape(value) << '\n';
+}
+
+static void journal_write_delete(std::ostream& stream, const std::string& md5)
+{
+    stream << JOURNAL_RECORD_DELETE << '\t' << md5 << '\n';
+}
+
+// replays the journal into l_gameSettings
+static void journal_read(void)
+{
+    std::ifstream stream(l_journalFile, std::ios::binary);
+    std::string line;
+
+    while (std::getline(stream, line))
+    {
+        size_t md5Start = line.find('\t');
+        if (line.empty() || md5Start == std::string::npos)
+        { // skip invalid record
+            continue;
+        }
+
+        md5Start++;
+        size_t keyStart = line.find('\t', md5Start);
+        std::string md5 = line.substr(md5Start, keyStart == std::string::npos ? std::string::npos : keyStart - md5Start);
+
+        if (line[0] == JOURNAL_RECORD_DELETE)
+        {
+            l_gameSettings.erase(md5);
+        }
+        else if (line[0] == JOURNAL_RECORD_SET && keyStart != std::string::npos)
+        {
+            keyStart++;
+            size_t valueStart = line.find('\t', keyStart);
+            if (valueStart == std::string::npos)
+            { // skip invalid record
+                continue;
+            }
+
+            std::string key = journal_unescape(line.substr(keyStart, valueStart - keyStart));
+            std::string value = journal_unescape(line.substr(valueStart + 1));
+            l_gameSettings[md5][key] = value;
+        }
+        else
+        { // skip invalid record
+            continue;
+        }
+
+        l_journalRecords++;
+    }
+}
+
+// rewrites the journal with only the
+// current values, the file is replaced
+// atomically by renaming it afterwards
+static bool journal_compact(void)
+{
+    std::string error;
+    std::error_code errorCode;
+    std::filesystem::path tmpFile = l_journalFile;
+    tmpFile += ".tmp";
+    int records = 0;
+
+    std::ofstream stream(tmpFile, std::ios::binary | std::ios::trunc);
+    if (!stream.is_open())
+    {
+        error = "journal_compact Failed: cannot open ";
+        error += tmpFile.string();
+        CoreSetError(error);
+        return false;
+    }
+
+    for (const auto& game : l_gameSettings)
+    {
+        for (const auto& setting : game.second)
+        {
+            journal_write_set(stream, game.first, setting.first, setting.second);
+            records++;
+        }
+    }
+
+    stream.close();
+    if (stream.fail())
+    {
+        error = "journal_compact Failed: cannot write ";
+        error += tmpFile.string();
+        CoreSetError(error);
+        std::filesystem::remove(tmpFile, errorCode);
+        return false;
+    }
+
+    std::filesystem::rename(tmpFile, l_journalFile, errorCode);
+    if (errorCode)
+    {
+        error = "journal_compact std::filesystem::rename Failed: ";
+        error += errorCode.message();
+        CoreSetError(error);
+        std::filesystem::remove(tmpFile, errorCode);
+        return false;
+    }
+
+    l_journalRecords = records;
+    return true;
+}
+
+//
+// Exported Functions
+//
+
+bool CoreGameSettingsOpen(std::string file)
+{
+    std::lock_guard<std::mutex> lock(l_gameSettingsMutex);
+    std::string error;
+    int values = 0;
+
+    if (l_isOpen)
+    {
+        return true;
+    }
+
+    l_journalFile = file;
+    l_journalRecords = 0;
+    l_gameSettings.clear();
+
+    journal_read();
+
+    for (const auto& game : l_gameSettings)
+    {
+        values += game.second.size();
+    }
+
+    if (l_journalRecords > JOURNAL_COMPACT_MIN_RECORDS &&
+        l_journalRecords > (values * 2))
+    {
+        // not being able to compact isn't fatal,
+        // the journal can still be appended to
+        journal_compact();
+    }
+
+    l_journalStream.open(l_journalFile, std::ios::binary | std::ios::app);
+    if (!l_journalStream.is_open())
+    {
+        error = "CoreGameSettingsOpen Failed: cannot open ";
+        error += l_journalFile.string();
+        CoreSetError(error);
+        return false;
+    }
+
+    l_isOpen = true;
+    return true;
+}
+
+bool CoreGameSettingsIsOpen(void)
+{
+    std::lock_guard<std::mutex> lock(l_gameSettingsMutex);
+    return l_isOpen;
+}
+
+bool CoreGameSettingsHasSection(std::string md5)
+{
+    std::lock_guard<std::mutex> lock(l_gameSettingsMutex);
+    return l_gameSettings.contains(md5);
+}
+
+bool CoreGameSettingsDeleteSection(std::string md5)
+{
+    std::lock_guard<std::mutex> lock(l_gameSettingsMutex);
+    std::string error;
+
+    if (!l_isOpen)
+    {
+        error = "CoreGameSettingsDeleteSection Failed: game settings haven't been opened!";
+        CoreSetError(error);
+        return false;
+    }
+
+    if (l_gameSettings.erase(md5) == 0)
+    {
+        return true;
+    }
+
+    journal_write_delete(l_journalStream, md5);
+    l_journalRecords++;
+    return true;
+}
+
+bool CoreGameSettingsSetValue(std::string md5, std::string key, std::string value)
+{
+    std::lock_guard<std::mutex> lock(l_gameSettingsMutex);
+    std::string error;
+
+    if (!l_isOpen)
+    {
+        error = "CoreGameSettingsSetValue Failed: game settings haven't been opened!";
+        CoreSetError(error);
+        return false;
+    }
+
+    auto& settings = l_gameSettings[md5];
+    auto iter = settings.find(key);
+    if (iter != settings.end() && iter->second == value)
+    {
+        return true;
+    }
+
+    settings[key] = value;
+    journal_write_set(l_journalStream, md5, key, value);
+    l_journalRecords++;
+    return true;
+}
+
+bool CoreGameSettingsGetValue(std::string md5, std::string key, std::string& value)
+{
+    std::lock_guard<std::mutex> lock(l_gameSettingsMutex);
+
+    auto gameIter = l_gameSettings.find(md5);
+    if (gameIter == l_gameSettings.end())
+    {
+        return false;
+    }
+
+    auto iter = gameIter->second.find(key);
+    if (iter == gameIter->second.end())
+    {
+        return false;
+    }
+
+    value = iter->second;
+    return true;
+}
+
+bool CoreGameSettingsFlush(void)
+{
+    std::lock_guard<std::mutex> lock(l_gameSettingsMutex);
+    std::string error;
+
+    if (!l_isOpen)
+    {
+        return true;
+    }
+
+    l_journalStream.flush();
+    if (l_journalStream.fail())
+    {
+        error = "CoreGameSettingsFlush Failed: cannot write ";
+        error += l_journalFile.string();
+        CoreSetError(error);
+        l_journalStream.clear();
+        return false;
+    }
+
+    return true;
+}
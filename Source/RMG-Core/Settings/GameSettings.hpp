@@ -0,0 +1,38 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_GAMESETTINGS_HPP
+#define CORE_GAMESETTINGS_HPP
+
+#include <string>
+
+// opens the game settings journal file,
+// it's created when it doesn't exist yet
+bool CoreGameSettingsOpen(std::string file);
+
+// returns whether the game settings have been opened
+bool CoreGameSettingsIsOpen(void);
+
+// returns whether the game has settings
+bool CoreGameSettingsHasSection(std::string md5);
+
+// deletes all settings of the game
+bool CoreGameSettingsDeleteSection(std::string md5);
+
+// sets game setting value
+bool CoreGameSettingsSetValue(std::string md5, std::string key, std::string value);
+
+// retrieves game setting value,
+// returns false when it doesn't exist
+bool CoreGameSettingsGetValue(std::string md5, std::string key, std::string& value);
+
+// flushes pending journal writes to file
+bool CoreGameSettingsFlush(void);
+
+#endif // CORE_GAMESETTINGS_HPP
@@ -7,496 +7,1174 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
+#define CORE_INTERNAL
 #include "Settings.hpp"
+#include "GameSettings.hpp"
+#include "SettingsEvents.hpp"
 
 #include "m64p/Api.hpp"
 #include "Error.hpp"
 #include "m64p/api/m64p_types.h"
 
-#include <exception>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
 #include <string>
+#include <string_view>
+#include <initializer_list>
+#include <iterator>
 #include <sstream>
 #include <algorithm>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <cerrno>
+
+#ifdef _WIN32
+#include <io.h>
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif // _WIN32
 
 //
 // Local Defines
 //
 
 #define STR_SIZE 4096
+#define CONFIG_FILE_NAME "mupen64plus.cfg"
+#define GAME_SETTINGS_FILE_NAME "RMG-GameSettings.journal"
+
+// delay in milliseconds after the last save request
+// before the settings are written to disk
+#define SETTINGS_WRITE_DELAY 1000
+
+#define SETTING_SECTION_GUI         "Rosalie's Mupen GUI"
+#define SETTING_SECTION_CORE        SETTING_SECTION_GUI  " Core"
+#define SETTING_SECTION_OVERLAY     SETTING_SECTION_CORE " Overlay"
+#define SETTING_SECTION_KEYBIND     SETTING_SECTION_GUI  " KeyBindings"
+#define SETTING_SECTION_ROMBROWSER  SETTING_SECTION_GUI  " RomBrowser"
+#define SETTING_SECTION_SETTINGS    SETTING_SECTION_CORE " Settings"
+#define SETTING_SECTION_M64P        "Core"
+#define SETTING_SECTION_AUDIO       SETTING_SECTION_GUI  " - Audio Plugin"
+#define SETTING_SECTION_GAME        ""
+
+#ifdef _WIN32
+#define SETTING_DEFAULT_GFX_PLUGIN   "Plugin\\GFX\\mupen64plus-video-GLideN64.dll"
+#define SETTING_DEFAULT_AUDIO_PLUGIN "Plugin\\Audio\\RMG-Audio.dll"
+#define SETTING_DEFAULT_INPUT_PLUGIN "Plugin\\Input\\libmupen64plus-input-qt.dll"
+#define SETTING_DEFAULT_RSP_PLUGIN   "Plugin\\RSP\\mupen64plus-rsp-hle.dll"
+#else
+#define SETTING_DEFAULT_GFX_PLUGIN   "Plugin/GFX/mupen64plus-video-GLideN64.so"
+#define SETTING_DEFAULT_AUDIO_PLUGIN "Plugin/Audio/RMG-Audio.so"
+#define SETTING_DEFAULT_INPUT_PLUGIN "Plugin/Input/libmupen64plus-input-qt.so"
+#define SETTING_DEFAULT_RSP_PLUGIN   "Plugin/RSP/mupen64plus-rsp-hle.so"
+#endif // _WIN32
+
+#define SETTING_INTLIST(...) std::initializer_list<int>{__VA_ARGS__}
 
 //
 // Local Structures
 //
 
-struct l_DynamicValue
+// default value of a setting,
+// int lists are stored in a fixed
+// size array so it can be constexpr
+struct l_DefaultValue
 {
-    int intValue;
-    bool boolValue;
-    float floatValue;
-    std::string stringValue;
-    std::vector<int> intListValue;
+    int intValue = 0;
+    bool boolValue = false;
+    float floatValue = 0;
+    std::string_view stringValue;
+    int intListValue[8] = {0};
+    int intListSize = 0;
+    bool isIntList = false;
 
-    m64p_type valueType;
+    m64p_type valueType = M64TYPE_STRING;
 
-    l_DynamicValue() {}
+    constexpr l_DefaultValue() {}
 
-    l_DynamicValue(int value)
-    {
-        intValue = value;
-        valueType = M64TYPE_INT;
-    }
+    constexpr l_DefaultValue(int value) : intValue(value), valueType(M64TYPE_INT) {}
 
-    l_DynamicValue(bool value)
-    {
-        boolValue = value;
-        valueType = M64TYPE_BOOL;
-    }
+    constexpr l_DefaultValue(bool value) : boolValue(value), valueType(M64TYPE_BOOL) {}
 
-    l_DynamicValue(float value)
-    {
-        floatValue = value;
-        valueType = M64TYPE_FLOAT;
-    }
+    constexpr l_DefaultValue(float value) : floatValue(value), valueType(M64TYPE_FLOAT) {}
 
-    l_DynamicValue(const char* value)
-    {
-        stringValue = std::string(value);
-        valueType = M64TYPE_STRING;
-    }
+    constexpr l_DefaultValue(const char* value) : stringValue(value), valueType(M64TYPE_STRING) {}
 
-    l_DynamicValue(std::vector<int> value)
+    constexpr l_DefaultValue(std::initializer_list<int> value) : isIntList(true), valueType(M64TYPE_STRING)
     {
-        intListValue = value;
-        // convert list to string
-        std::string value_str;
         for (int num : value)
         {
-            value_str += std::to_string(num);
-            value_str += ";";
+            intListValue[intListSize++] = num;
         }
-        stringValue = value_str;
-        valueType = M64TYPE_STRING;
     }
 };
 
 struct l_Setting
 {
-    std::string Section;
-    std::string Key;
-    l_DynamicValue DefaultValue;
-    std::string Description = "";
+    std::string_view Section;
+    std::string_view Key;
+    l_DefaultValue DefaultValue;
+    std::string_view Description = "";
     bool ForceUseSetOnce = false;
 };
 
+// hash which allows looking up std::string
+// keys using std::string_view without a copy
+struct l_StringHash
+{
+    using is_transparent = void;
+
+    size_t operator()(std::string_view str) const
+    {
+        return std::hash<std::string_view>{}(str);
+    }
+};
+
+// cached value of a setting in its own section,
+// each type is cached separately because
+// a setting can be retrieved as different types
+struct l_CachedValue
+{
+    bool IntValid = false;
+    int IntValue = 0;
+    bool BoolValid = false;
+    bool BoolValue = false;
+    bool FloatValid = false;
+    float FloatValue = 0;
+    bool StringValid = false;
+    std::string StringValue;
+    bool IntListValid = false;
+    std::vector<int> IntListValue;
+    bool BlobValid = false;
+    std::vector<char> BlobValue;
+};
+
+// state of the settings writer thread,
+// the thread is stopped when the library
+// is unloaded, pending writes should be
+// flushed with CoreSettingsFlush() before that
+struct l_SettingsWriter
+{
+    std::thread thread;
+    std::condition_variable condition;
+    std::chrono::steady_clock::time_point deadline;
+    bool pending = false;
+    bool busy = false;
+    bool stop = false;
+
+    ~l_SettingsWriter(void);
+};
+
 //
 // Local Variables
 //
 
-static m64p_handle              l_sectionHandle = nullptr;
-static std::vector<std::string> l_sectionList;
+// settings table, generated from SETTINGS_LIST
+// so it's indexed by SettingsID
+static constexpr l_Setting l_settings[] =
+{
+#define SETTING(id, section, key, value)          {section, key, value},
+#define SETTING_SET_ONCE(id, section, key, value) {section, key, value, "", true},
+    SETTINGS_LIST(SETTING, SETTING_SET_ONCE)
+#undef SETTING
+#undef SETTING_SET_ONCE
+};
+
+static constexpr l_Setting l_invalidSetting = {"", "", ""};
+
+static_assert(std::size(l_settings) == (size_t)SettingsID::Invalid,
+    "l_settings must contain an entry for each SettingsID");
+
+static constexpr bool l_settingsHaveKeys = []
+{
+    for (const l_Setting& setting : l_settings)
+    {
+        if (setting.Key.empty())
+        {
+            return false;
+        }
+    }
+    return true;
+}();
+
+static_assert(l_settingsHaveKeys, "each setting in l_settings must have a key");
+
+static m64p_handle                                  l_sectionHandle = nullptr;
+static std::unordered_set<std::string, l_StringHash, std::equal_to<>> l_sectionList;
+static bool                                         l_sectionListValid = false;
+static std::unordered_map<std::string, m64p_handle, l_StringHash, std::equal_to<>> l_sectionHandles;
+static std::unordered_map<std::string, std::string, l_StringHash, std::equal_to<>> l_sectionData;
+static l_CachedValue                                l_cachedValues[(int)SettingsID::Invalid];
+static std::recursive_mutex                         l_settingsMutex;
+static int                                          l_batchDepth = 0;
+static bool                                         l_settingsDirty = false;
+static bool                                         l_settingsFileOwner = false;
+static bool                                         l_settingsWritten = false;
+static size_t                                       l_settingsWrittenHash = 0;
+static std::mutex                                   l_writerMutex;
+static l_SettingsWriter                             l_writer;
 
 //
 // Local Functions
 //
 
-#define SETTING_SECTION_GUI         "Rosalie's Mupen GUI"
-#define SETTING_SECTION_CORE        SETTING_SECTION_GUI  " Core"
-#define SETTING_SECTION_OVERLAY     SETTING_SECTION_CORE " Overlay"
-#define SETTING_SECTION_KEYBIND     SETTING_SECTION_GUI  " KeyBindings"
-#define SETTING_SECTION_ROMBROWSER  SETTING_SECTION_GUI  " RomBrowser"
-#define SETTING_SECTION_SETTINGS    SETTING_SECTION_CORE " Settings"
-#define SETTING_SECTION_M64P        "Core"
-#define SETTING_SECTION_AUDIO       SETTING_SECTION_GUI  " - Audio Plugin"
+l_SettingsWriter::~l_SettingsWriter(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(l_writerMutex);
+        this->stop = true;
+        this->condition.notify_all();
+    }
+
+    if (this->thread.joinable())
+    {
+        this->thread.join();
+    }
+}
 
 // retrieves l_Setting from settingId
-static l_Setting get_setting(SettingsID settingId)
+static const l_Setting& get_setting(SettingsID settingId)
+{
+    if ((int)settingId < 0 || settingId >= SettingsID::Invalid)
+    {
+        return l_invalidSetting;
+    }
+
+    return l_settings[(int)settingId];
+}
+
+static const char l_base64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// encodes blob as base64, so it can be
+// stored in the text based config file
+static std::string blob_to_string(const std::vector<char>& blob)
+{
+    std::string value_str;
+    value_str.reserve(((blob.size() + 2) / 3) * 4);
+
+    for (size_t i = 0; i < blob.size(); i += 3)
+    {
+        size_t remaining = blob.size() - i;
+        unsigned int triple = ((unsigned char)blob[i]) << 16;
+        if (remaining > 1)
+        {
+            triple |= ((unsigned char)blob[i + 1]) << 8;
+        }
+        if (remaining > 2)
+        {
+            triple |= ((unsigned char)blob[i + 2]);
+        }
+
+        value_str += l_base64Chars[(triple >> 18) & 0x3F];
+        value_str += l_base64Chars[(triple >> 12) & 0x3F];
+        value_str += remaining > 1 ? l_base64Chars[(triple >> 6) & 0x3F] : '=';
+        value_str += remaining > 2 ? l_base64Chars[triple & 0x3F] : '=';
+    }
+
+    return value_str;
+}
+
+// decodes base64 encoded blob,
+// invalid characters are skipped
+static std::vector<char> string_to_blob(std::string_view value_str)
 {
-    l_Setting setting;
+    std::vector<char> blob;
+    unsigned int bits = 0;
+    int bitCount = 0;
 
-    switch (settingId)
+    blob.reserve((value_str.size() / 4) * 3);
+
+    for (char c : value_str)
+    {
+        const char* pos = (c != '\0') ? std::strchr(l_base64Chars, c) : nullptr;
+        if (pos == nullptr)
+        {
+            continue;
+        }
+
+        bits = (bits << 6) | (unsigned int)(pos - l_base64Chars);
+        bitCount += 6;
+
+        if (bitCount >= 8)
+        {
+            bitCount -= 8;
+            blob.emplace_back((char)((bits >> bitCount) & 0xFF));
+        }
+    }
+
+    return blob;
+}
+
+// converts int list to base64 of
+// little-endian 32-bit ints
+static std::string int_list_to_string(const int* list, size_t size)
+{
+    std::vector<char> blob(size * 4);
+
+    for (size_t i = 0; i < size; i++)
+    {
+        uint32_t num = (uint32_t)list[i];
+        blob[(i * 4) + 0] = (char)(num & 0xFF);
+        blob[(i * 4) + 1] = (char)((num >> 8) & 0xFF);
+        blob[(i * 4) + 2] = (char)((num >> 16) & 0xFF);
+        blob[(i * 4) + 3] = (char)((num >> 24) & 0xFF);
+    }
+
+    return blob_to_string(blob);
+}
+
+// parses the ';' separated representation of an int list
+// which older versions stored, invalid items are skipped
+static std::vector<int> legacy_string_to_int_list(std::string_view value_str)
+{
+    std::vector<int> list;
+
+    while (!value_str.empty())
+    {
+        size_t end = value_str.find(';');
+        std::string_view item = value_str.substr(0, end);
+
+        int num;
+        auto result = std::from_chars(item.data(), item.data() + item.size(), num);
+        if (result.ec == std::errc() && result.ptr == item.data() + item.size())
+        {
+            list.emplace_back(num);
+        }
+
+        if (end == std::string_view::npos)
+        {
+            break;
+        }
+
+        value_str.remove_prefix(end + 1);
+    }
+
+    return list;
+}
+
+// parses the base64 representation of an int list,
+// a value which isn't valid base64 of whole ints
+// is parsed as the ';' separated representation
+static std::vector<int> string_to_int_list(std::string_view value_str)
+{
+    std::vector<int> list;
+    std::vector<char> blob;
+
+    if (value_str.find(';') != std::string_view::npos ||
+        value_str.size() % 4 != 0)
+    {
+        return legacy_string_to_int_list(value_str);
+    }
+
+    blob = string_to_blob(value_str);
+    if (blob.size() % 4 != 0)
+    {
+        return legacy_string_to_int_list(value_str);
+    }
+
+    list.reserve(blob.size() / 4);
+    for (size_t i = 0; i < blob.size(); i += 4)
+    {
+        uint32_t num = ((uint32_t)(unsigned char)blob[i + 0]) |
+                       ((uint32_t)(unsigned char)blob[i + 1] << 8) |
+                       ((uint32_t)(unsigned char)blob[i + 2] << 16) |
+                       ((uint32_t)(unsigned char)blob[i + 3] << 24);
+        list.emplace_back((int)num);
+    }
+
+    return list;
+}
+
+// returns the default value of setting as string,
+// int lists are converted to base64
+static std::string get_default_string(const l_Setting& setting)
+{
+    if (!setting.DefaultValue.isIntList)
+    {
+        return std::string(setting.DefaultValue.stringValue);
+    }
+
+    return int_list_to_string(setting.DefaultValue.intListValue, setting.DefaultValue.intListSize);
+}
+
+// retrieves the cached value of settingId,
+// returns nullptr when it can't be cached
+static l_CachedValue* get_cached_value(SettingsID settingId)
+{
+    if ((int)settingId < 0 || settingId >= SettingsID::Invalid)
+    {
+        return nullptr;
+    }
+
+    return &l_cachedValues[(int)settingId];
+}
+
+// invalidates the cached values of
+// settings stored in section (and key)
+// and notifies their subscribers
+static void invalidate_cached_values(std::string_view section, std::string_view key = "")
+{
+    for (int i = 0; i < (int)SettingsID::Invalid; i++)
+    {
+        const l_Setting& setting = get_setting((SettingsID)i);
+        if (setting.Section == section &&
+            (key.empty() || setting.Key == key))
+        {
+            l_cachedValues[i] = l_CachedValue();
+            CoreSettingsNotifyChanged((SettingsID)i);
+        }
+    }
+}
+
+// marks section as changed, so it's
+// serialized again on the next save,
+// l_settingsMutex must be locked
+static void mark_section_dirty(std::string_view section)
+{
+    l_settingsDirty = true;
+
+    auto iter = l_sectionData.find(section);
+    if (iter != l_sectionData.end())
+    {
+        l_sectionData.erase(iter);
+    }
+}
+
+static void config_listsections_callback(void* context, const char* section)
+{
+    l_sectionList.emplace(std::string(section));
+}
+
+static void config_listparameters_callback(void* context, const char* name, m64p_type type)
+{
+    std::vector<std::pair<std::string, m64p_type>>* parameters = (std::vector<std::pair<std::string, m64p_type>>*)context;
+    parameters->emplace_back(std::string(name), type);
+}
+
+static void config_listsections_vector_callback(void* context, const char* section)
+{
+    std::vector<std::string>* sections = (std::vector<std::string>*)context;
+    sections->emplace_back(std::string(section));
+}
+
+static bool config_section_exists(std::string_view section)
+{
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    m64p_error ret;
+
+    // only retrieve the section list once,
+    // afterwards it's kept up-to-date by
+    // config_section_open() and CoreSettingsDeleteSection()
+    if (!l_sectionListValid)
+    {
+        l_sectionList.clear();
+
+        ret = m64p::Config.ListSections(nullptr, &config_listsections_callback);
+        if (ret != M64ERR_SUCCESS)
+        {
+            CoreSetError("config_section_exists m64p::Config.ListSections Failed: ", m64p::Core.ErrorMessage(ret));
+            return false;
+        }
+
+        l_sectionListValid = true;
+    }
+
+    return l_sectionList.contains(section);
+}
+
+static bool config_section_open(std::string_view section)
+{
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    m64p_error ret;
+
+    if (section.empty())
+    {
+        CoreSetError("config_section_open Failed: cannot open empty section!");
+        return false;
+    }
+
+    // re-use the handle when we've opened
+    // the section before
+    auto iter = l_sectionHandles.find(section);
+    if (iter != l_sectionHandles.end())
+    {
+        l_sectionHandle = iter->second;
+        return true;
+    }
+
+    ret = m64p::Config.OpenSection(std::string(section).c_str(), &l_sectionHandle);
+    if (ret != M64ERR_SUCCESS)
+    {
+        CoreSetError("config_section_open Failed: ", m64p::Core.ErrorMessage(ret));
+        return false;
+    }
+
+    // opening a section creates it
+    // when it doesn't exist yet
+    l_sectionHandles.emplace(section, l_sectionHandle);
+    if (l_sectionListValid)
+    {
+        l_sectionList.emplace(section);
+    }
+
+    return true;
+}
+
+// returns whether section is a game section,
+// those are named after the MD5 of the ROM
+static bool is_game_section(std::string_view section)
+{
+    if (section.size() != 32)
+    {
+        return false;
+    }
+
+    return std::all_of(section.begin(), section.end(), [](char c)
+    {
+        return std::isxdigit((unsigned char)c) != 0;
+    });
+}
+
+// converts the parameter in the currently opened
+// section to the string representation used
+// by the game settings
+static std::string config_parameter_to_string(const char* name, m64p_type type)
+{
+    switch (type)
     {
     default:
-        setting = {"", "", "", "", false};
-        break;
+        return "";
+    case M64TYPE_INT:
+        return std::to_string(m64p::Config.GetParamInt(l_sectionHandle, name));
+    case M64TYPE_FLOAT:
+        return std::to_string(m64p::Config.GetParamFloat(l_sectionHandle, name));
+    case M64TYPE_BOOL:
+        return m64p::Config.GetParamBool(l_sectionHandle, name) ? "True" : "False";
+    case M64TYPE_STRING:
+    {
+        const char* value = m64p::Config.GetParamString(l_sectionHandle, name);
+        return value != nullptr ? value : "";
+    }
+    }
+}
 
-    case SettingsID::GUI_SettingsDialogWidth:
-        setting = {SETTING_SECTION_GUI, "SettingsDialogWidth", 0};
-        break;
-    case SettingsID::GUI_SettingsDialogHeight:
-        setting = {SETTING_SECTION_GUI, "SettingsDialogHeight", 0};
-        break;
-    case SettingsID::GUI_AllowManualResizing:
-        setting = {SETTING_SECTION_GUI, "AllowManualResizing", true};
-        break;
-    case SettingsID::GUI_HideCursorInEmulation:
-        setting = {SETTING_SECTION_GUI, "HideCursorInEmulation", false};
-        break;
-    case SettingsID::GUI_StatusbarMessageDuration:
-        setting = {SETTING_SECTION_GUI, "StatusbarMessageDuration", 3};
-        break;
+// opens the game settings, the first time
+// game sections in the mupen64plus config
+// are moved to the game settings
+static bool game_settings_open(void)
+{
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    m64p_error ret;
+    std::vector<std::string> sections;
 
-    case SettingsID::Core_GFX_Plugin:
-        setting = {SETTING_SECTION_CORE, "GFX_Plugin", 
-#ifdef _WIN32
-                    "Plugin\\GFX\\mupen64plus-video-GLideN64.dll",
-#else
-                    "Plugin/GFX/mupen64plus-video-GLideN64.so", 
-#endif // _WIN32
-                  };
-        break;
-    case SettingsID::Core_AUDIO_Plugin:
-        setting = {SETTING_SECTION_CORE, "AUDIO_Plugin", 
-#ifdef _WIN32
-                    "Plugin\\Audio\\RMG-Audio.dll",
-#else
-                    "Plugin/Audio/RMG-Audio.so",
-#endif // _WIN32
-                  };
-        break;
-    case SettingsID::Core_INPUT_Plugin:
-        setting = {SETTING_SECTION_CORE, "INPUT_Plugin", 
-#ifdef _WIN32
-                    "Plugin\\Input\\libmupen64plus-input-qt.dll",
-#else
-                    "Plugin/Input/libmupen64plus-input-qt.so",
-#endif // _WIN32
-                  };
-        break;
-    case SettingsID::Core_RSP_Plugin:
-        setting = {SETTING_SECTION_CORE, "RSP_Plugin", 
-#ifdef _WIN32
-                    "Plugin\\RSP\\mupen64plus-rsp-hle.dll",
-#else
-                    "Plugin/RSP/mupen64plus-rsp-hle.so",
-#endif // _WIN32
-                  };
-        break;
+    if (CoreGameSettingsIsOpen())
+    {
+        return true;
+    }
 
-    case SettingsID::Core_OverrideUserDirs:
-        setting = {SETTING_SECTION_CORE, "OverrideUserDirectories", true};
-        break;
-    case SettingsID::Core_UserDataDirOverride:
-        setting = {SETTING_SECTION_CORE, "UserDataDirectory", "Data"};
-        break;
-    case SettingsID::Core_UserCacheDirOverride:
-        setting = {SETTING_SECTION_CORE, "UserCacheDirectory", "Cache"};
-        break;
+    const char* configPath = m64p::Config.GetUserConfigPath();
+    if (configPath == nullptr)
+    {
+        CoreSetError("game_settings_open m64p::Config.GetUserConfigPath Failed!");
+        return false;
+    }
 
-    case SettingsID::Core_OverrideGameSpecificSettings:
-        setting = {SETTING_SECTION_CORE, "OverrideGameSpecificSettings", false};
-        break;
+    std::filesystem::path filePath = std::filesystem::path(configPath) / GAME_SETTINGS_FILE_NAME;
+    bool migrate = !std::filesystem::exists(filePath);
 
-    case SettingsID::Core_RandomizeInterrupt:
-        setting = {SETTING_SECTION_OVERLAY, "RandomizeInterrupt", true};
-        break;
-    case SettingsID::Core_CPU_Emulator:
-        setting = {SETTING_SECTION_OVERLAY, "CPU_Emulator", 2};
-        break;
-    case SettingsID::Core_DisableExtraMem:
-        setting = {SETTING_SECTION_OVERLAY, "DisableExtraMem", false};
-        break;
-    case SettingsID::Core_EnableDebugger:
-        setting = {SETTING_SECTION_OVERLAY, "EnableDebugger", false};
-        break;
-    case SettingsID::Core_CountPerOp:
-        setting = {SETTING_SECTION_OVERLAY, "CountPerOp", 0};
-        break;
-    case SettingsID::Core_SiDmaDuration:
-        setting = {SETTING_SECTION_OVERLAY, "SiDmaDuration", -1};
-        break;
+    if (!CoreGameSettingsOpen(filePath.string()))
+    {
+        return false;
+    }
 
-    case SettingsID::Core_ScreenshotPath:
-        setting = {SETTING_SECTION_M64P, "ScreenshotPath", "Screenshots", "", true};
-        break;
-    case SettingsID::Core_SaveStatePath:
-        setting = {SETTING_SECTION_M64P, "SaveStatePath", "Save/State", "", true};
-        break;
-    case SettingsID::Core_SaveSRAMPath:
-        setting = {SETTING_SECTION_M64P, "SaveSRAMPath", "Save/Game", "", true};
-        break;
-    case SettingsID::Core_SharedDataPath:
-        setting = {SETTING_SECTION_M64P, "SharedDataPath", "Data", "", true};
-        break;
+    if (!migrate)
+    {
+        return true;
+    }
 
-    case SettingsID::Core_64DD_RomFile:
-        setting = {SETTING_SECTION_CORE, "64DD_RomFile", ""};
-        break;
+    ret = m64p::Config.ListSections(&sections, &config_listsections_vector_callback);
+    if (ret != M64ERR_SUCCESS)
+    {
+        CoreSetError("game_settings_open m64p::Config.ListSections Failed: ", m64p::Core.ErrorMessage(ret));
+        return false;
+    }
 
-    case SettingsID::Game_DisableExtraMem:
-        setting = {"", "DisableExtraMem", false};
-        break;
-    case SettingsID::Game_SaveType:
-        setting = {"", "SaveType", 0};
-        break;
-    case SettingsID::Game_CountPerOp:
-        setting = {"", "CountPerOp", 2};
-        break;
-    case SettingsID::Game_SiDmaDuration:
-        setting = {"", "SiDmaDuration", 2304};
-        break;
+    for (const std::string& section : sections)
+    {
+        std::vector<std::pair<std::string, m64p_type>> parameters;
 
-    case SettingsID::Game_OverrideCoreSettings:
-        setting = {"", "OverrideCoreSettings", false};
-        break;
-    case SettingsID::Game_CPU_Emulator:
-        setting = {"", "CPU_Emulator", 2};
-        break;
-    case SettingsID::Game_RandomizeInterrupt:
-        setting = {"", "RandomizeInterrupt", true};
-        break;
+        if (!is_game_section(section) ||
+            !config_section_open(section))
+        {
+            continue;
+        }
 
-    case SettingsID::Game_GFX_Plugin:
-        setting = {"", "GFX_Plugin", ""};
-        break;
-    case SettingsID::Game_AUDIO_Plugin:
-        setting = {"", "AUDIO_Plugin", ""};
-        break;
-    case SettingsID::Game_INPUT_Plugin:
-        setting = {"", "INPUT_Plugin", ""};
-        break;
-    case SettingsID::Game_RSP_Plugin:
-        setting = {"", "RSP_Plugin", ""};
-        break;
+        ret = m64p::Config.ListParameters(l_sectionHandle, &parameters, &config_listparameters_callback);
+        if (ret != M64ERR_SUCCESS)
+        {
+            continue;
+        }
 
-    case SettingsID::KeyBinding_OpenROM:
-        setting = {SETTING_SECTION_KEYBIND, "OpenROM", "Ctrl+O"};
-        break;
-    case SettingsID::KeyBinding_OpenCombo:
-        setting = {SETTING_SECTION_KEYBIND, "OpenCombo", "Ctrl+Shift+O"};
-        break;
-    case SettingsID::KeyBinding_StartEmulation:
-        setting = {SETTING_SECTION_KEYBIND, "StartEmulation", "F11"};
-        break;
-    case SettingsID::KeyBinding_EndEmulation:
-        setting = {SETTING_SECTION_KEYBIND, "EndEmulation", "F12"};
-        break;
-    case SettingsID::KeyBinding_RefreshROMList:
-        setting = {SETTING_SECTION_KEYBIND, "RefreshROMList", "F5"};
-        break;
-    case SettingsID::KeyBinding_Exit:
-        setting = {SETTING_SECTION_KEYBIND, "Exit", "Alt+F4"};
-        break;
-    case SettingsID::KeyBinding_SoftReset:
-        setting = {SETTING_SECTION_KEYBIND, "SoftReset", "F1"};
-        break;
-    case SettingsID::KeyBinding_HardReset:
-        setting = {SETTING_SECTION_KEYBIND, "HardReset", "Shift+F1"};
-        break;
-    case SettingsID::KeyBinding_Resume:
-        setting = {SETTING_SECTION_KEYBIND, "Resume", "F2"};
-        break;
-    case SettingsID::KeyBinding_GenerateBitmap:
-        setting = {SETTING_SECTION_KEYBIND, "GenerateBitmap", "F3"};
-        break;
-    case SettingsID::KeyBinding_LimitFPS:
-        setting = {SETTING_SECTION_KEYBIND, "LimitFPS", "F4"};
-        break;
-    case SettingsID::KeyBinding_SwapDisk:
-        setting = {SETTING_SECTION_KEYBIND, "SwapDisk", "Ctrl+D"};
-        break;
-    case SettingsID::KeyBinding_SaveState:
-        setting = {SETTING_SECTION_KEYBIND, "SaveState", "F5"};
-        break;
-    case SettingsID::KeyBinding_SaveAs:
-        setting = {SETTING_SECTION_KEYBIND, "SaveAs", "Ctrl+S"};
-        break;
-    case SettingsID::KeyBinding_LoadState:
-        setting = {SETTING_SECTION_KEYBIND, "LoadState", "F7"};
-        break;
-    case SettingsID::KeyBinding_Load:
-        setting = {SETTING_SECTION_KEYBIND, "Load", "Ctrl+L"};
-        break;
-    case SettingsID::KeyBinding_Cheats:
-        setting = {SETTING_SECTION_KEYBIND, "Cheats", "Ctrl+C"};
+        for (const auto& parameter : parameters)
+        {
+            CoreGameSettingsSetValue(section, parameter.first,
+                config_parameter_to_string(parameter.first.c_str(), parameter.second));
+        }
+
+        ret = m64p::Config.DeleteSection(section.c_str());
+        if (ret == M64ERR_SUCCESS)
+        {
+            l_sectionList.erase(section);
+            l_sectionHandles.erase(section);
+            mark_section_dirty(section);
+        }
+    }
+
+    return CoreGameSettingsFlush();
+}
+
+static bool game_option_set(std::string_view section, std::string_view key, m64p_type type, void *value)
+{
+    std::string value_str;
+
+    if (!game_settings_open())
+    {
+        return false;
+    }
+
+    switch (type)
+    {
+    default:
+        CoreSetError("game_option_set Failed: invalid type parameter!");
+        return false;
+    case M64TYPE_INT:
+        value_str = std::to_string(*(int*)value);
         break;
-    case SettingsID::KeyBinding_GSButton:
-        setting = {SETTING_SECTION_KEYBIND, "GSButton", "F9"};
+    case M64TYPE_FLOAT:
+        value_str = std::to_string(*(float*)value);
         break;
-    case SettingsID::KeyBinding_Fullscreen:
-        setting = {SETTING_SECTION_KEYBIND, "Fullscreen", "Alt+Return"};
+    case M64TYPE_BOOL:
+        value_str = *(bool*)value ? "True" : "False";
         break;
-    case SettingsID::KeyBinding_Settings:
-        setting = {SETTING_SECTION_KEYBIND, "Settings", "Ctrl+T"};
+    case M64TYPE_STRING:
+        value_str = (char*)value;
         break;
+    }
 
-    case SettingsID::RomBrowser_Directory:
-        setting = {SETTING_SECTION_ROMBROWSER, "Directory", ""};
-        break;
-    case SettingsID::RomBrowser_Geometry:
-        setting = {SETTING_SECTION_ROMBROWSER, "Geometry", ""};
-        break;
-    case SettingsID::RomBrowser_Recursive:
-        setting = {SETTING_SECTION_ROMBROWSER, "Recursive", true};
+    return CoreGameSettingsSetValue(std::string(section), std::string(key), value_str);
+}
+
+static bool game_option_get(std::string_view section, std::string_view key, m64p_type type, void *value, int size)
+{
+    std::string value_str;
+
+    if (!game_settings_open())
+    {
+        return false;
+    }
+
+    if (!CoreGameSettingsHasSection(std::string(section)))
+    {
+        CoreSetError("game_option_get Failed: cannot open non-existent section!");
+        return false;
+    }
+
+    if (!CoreGameSettingsGetValue(std::string(section), std::string(key), value_str))
+    {
+        CoreSetError("game_option_get Failed: cannot retrieve non-existent parameter!");
+        return false;
+    }
+
+    switch (type)
+    {
+    default:
+        CoreSetError("game_option_get Failed: invalid type parameter!");
+        return false;
+    case M64TYPE_INT:
+        *(int*)value = std::atoi(value_str.c_str());
         break;
-    case SettingsID::RomBrowser_MaxItems:
-        setting = {SETTING_SECTION_ROMBROWSER, "MaxItems", 50};
+    case M64TYPE_FLOAT:
+        *(float*)value = std::strtof(value_str.c_str(), nullptr);
         break;
-    case SettingsID::RomBrowser_Columns:
-        setting = {SETTING_SECTION_ROMBROWSER, "Columns", std::vector<int>({0, 1, 2})};
+    case M64TYPE_BOOL:
+        *(int*)value = (value_str == "True") ? 1 : ((value_str == "False") ? 0 : std::atoi(value_str.c_str()));
         break;
-    case SettingsID::RomBrowser_ColumnSizes:
-        setting = {SETTING_SECTION_ROMBROWSER, "ColumnSizes", std::vector<int>({0, 250, 1, 100, 2, 100})};
+    case M64TYPE_STRING:
+        if (size <= 0)
+        {
+            return false;
+        }
+        std::strncpy((char*)value, value_str.c_str(), size - 1);
+        ((char*)value)[size - 1] = '\0';
         break;
+    }
 
-    case SettingsID::Settings_HasForceUsedSetOnce:
-        setting = {SETTING_SECTION_SETTINGS, "HasForceUsedSetOnce", false};
-        break;
+    return true;
+}
 
-    case SettingsID::Audio_Volume:
-        setting = {SETTING_SECTION_AUDIO, "Volume", 100};
-        break;
-    case SettingsID::Audio_Muted:
-        setting = {SETTING_SECTION_AUDIO, "Muted", false};
-        break;
+static bool config_option_set(std::string_view section, std::string_view key, m64p_type type, void *value)
+{
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    m64p_error ret;
+
+    if (is_game_section(section))
+    {
+        return game_option_set(section, key, type, value);
     }
 
-    return setting;
+    if (!config_section_open(section))
+    {
+        return false;
+    }
+
+    ret = m64p::Config.SetParameter(l_sectionHandle, std::string(key).c_str(), type, value);
+    if (ret != M64ERR_SUCCESS)
+    {
+        CoreSetError("config_option_set m64p::Config.SetParameter Failed: ", m64p::Core.ErrorMessage(ret));
+    }
+    else
+    {
+        mark_section_dirty(section);
+    }
+
+    invalidate_cached_values(section, key);
+
+    return ret == M64ERR_SUCCESS;
 }
 
-static void config_listsections_callback(void* context, const char* section)
+static bool config_option_get(std::string_view section, std::string_view key, m64p_type type, void *value, int size)
 {
-    l_sectionList.emplace_back(std::string(section));
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    m64p_error ret;
+
+    if (is_game_section(section))
+    {
+        return game_option_get(section, key, type, value, size);
+    }
+
+    if (!config_section_exists(section))
+    {
+        CoreSetError("config_option_get Failed: cannot open non-existent section!");
+        return false;
+    }
+
+    if (!config_section_open(section))
+    {
+        return false;
+    }
+
+    ret = m64p::Config.GetParameter(l_sectionHandle, std::string(key).c_str(), type, value, size);
+    if (ret != M64ERR_SUCCESS)
+    {
+        CoreSetError("config_option_get m64p::Config.GetParameter Failed: ", m64p::Core.ErrorMessage(ret));
+    }
+
+    return ret == M64ERR_SUCCESS;
+}
+
+static bool config_option_default_set(std::string_view section, std::string_view key, m64p_type type, const void *value, const char* description)
+{
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    std::string error;
+    m64p_error ret;
+
+    if (!config_section_open(section))
+    {
+        return false;
+    }
+
+    // setting a default value doesn't change
+    // an existing parameter, so it only makes
+    // the settings dirty when it doesn't exist yet
+    m64p_type existingType;
+    if (m64p::Config.GetParameterType(l_sectionHandle, std::string(key).c_str(), &existingType) == M64ERR_SUCCESS)
+    {
+        return true;
+    }
+
+    switch (type)
+    {
+        default:
+        {
+            ret = M64ERR_INPUT_INVALID;
+            error = "config_option_default_set Failed: invalid type parameter!";
+        } break;
+        case M64TYPE_INT:
+        {
+            ret = m64p::Config.SetDefaultInt(l_sectionHandle, std::string(key).c_str(), *(const int*)value, description);
+            error = "config_option_default_set m64p::Config.SetDefaultInt Failed: ";
+            error += m64p::Core.ErrorMessage(ret);
+        } break;
+        case M64TYPE_BOOL:
+        {
+            ret = m64p::Config.SetDefaultBool(l_sectionHandle, std::string(key).c_str(), *(const bool*)value, description);
+            error = "config_option_default_set m64p::Config.SetDefaultBool Failed: ";
+            error += m64p::Core.ErrorMessage(ret);
+        } break;
+        case M64TYPE_FLOAT:
+        {
+            ret = m64p::Config.SetDefaultFloat(l_sectionHandle, std::string(key).c_str(), *(const float*)value, description);
+            error = "config_option_default_set m64p::Config.SetDefaultFloat Failed: ";
+            error += m64p::Core.ErrorMessage(ret);
+        } break;
+        case M64TYPE_STRING:
+        {
+            ret = m64p::Config.SetDefaultString(l_sectionHandle, std::string(key).c_str(), (const char*)value, description);
+            error = "config_option_default_set m64p::Config.SetDefaultString Failed: ";
+            error += m64p::Core.ErrorMessage(ret);
+        } break;
+    }
+
+    if (ret != M64ERR_SUCCESS)
+    {
+        CoreSetError(error);
+    }
+    else
+    {
+        mark_section_dirty(section);
+    }
+
+    invalidate_cached_values(section, key);
+    return ret == M64ERR_SUCCESS;
+}
+
+// writes the section to stream in the
+// same format as the mupen64plus core,
+// including the preceding empty line
+static bool config_section_write(std::ostream& stream, std::string section)
+{
+    m64p_error ret;
+    std::vector<std::pair<std::string, m64p_type>> parameters;
+
+    if (!config_section_open(section))
+    {
+        return false;
+    }
+
+    ret = m64p::Config.ListParameters(l_sectionHandle, &parameters, &config_listparameters_callback);
+    if (ret != M64ERR_SUCCESS)
+    {
+        CoreSetError("config_section_write m64p::Config.ListParameters Failed: ", m64p::Core.ErrorMessage(ret));
+        return false;
+    }
+
+    stream << "\n[" << section << "]\n\n";
+
+    for (const auto& parameter : parameters)
+    {
+        const char* name = parameter.first.c_str();
+        const char* help = m64p::Config.GetParameterHelp(l_sectionHandle, name);
+
+        if (help != nullptr && help[0] != '\0')
+        {
+            stream << "# " << help << "\n";
+        }
+
+        switch (parameter.second)
+        {
+        default:
+            break;
+        case M64TYPE_INT:
+            stream << name << " = " << m64p::Config.GetParamInt(l_sectionHandle, name) << "\n";
+            break;
+        case M64TYPE_FLOAT:
+        {
+            char value[64] = {0};
+            snprintf(value, sizeof(value), "%f", m64p::Config.GetParamFloat(l_sectionHandle, name));
+            stream << name << " = " << value << "\n";
+        } break;
+        case M64TYPE_BOOL:
+            stream << name << " = " << (m64p::Config.GetParamBool(l_sectionHandle, name) ? "True" : "False") << "\n";
+            break;
+        case M64TYPE_STRING:
+        {
+            const char* value = m64p::Config.GetParamString(l_sectionHandle, name);
+            stream << name << " = \"" << (value != nullptr ? value : "") << "\"\n";
+        } break;
+        }
+    }
+
+    return true;
+}
+
+// serializes all sections in the
+// same format as the mupen64plus core,
+// only sections which have changed since
+// the last call are serialized again
+static bool config_file_serialize(std::string& data)
+{
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    m64p_error ret;
+    std::vector<std::string> sections;
+
+    ret = m64p::Config.ListSections(&sections, &config_listsections_vector_callback);
+    if (ret != M64ERR_SUCCESS)
+    {
+        CoreSetError("config_file_serialize m64p::Config.ListSections Failed: ", m64p::Core.ErrorMessage(ret));
+        return false;
+    }
+
+    data = "# Mupen64Plus Configuration File\n";
+    data += "# This file is automatically read and written by the Mupen64Plus Core library\n";
+
+    for (const std::string& section : sections)
+    {
+        auto iter = l_sectionData.find(section);
+        if (iter == l_sectionData.end())
+        {
+            std::ostringstream stream;
+            if (!config_section_write(stream, section))
+            {
+                return false;
+            }
+
+            iter = l_sectionData.emplace(section, stream.str()).first;
+        }
+
+        data += iter->second;
+    }
+
+    return true;
 }
 
-static bool config_section_exists(std::string section)
+// writes data to a temporary file and
+// renames it over the config file afterwards,
+// so the config file is never left half-written,
+// the temporary file is unique for this process
+// and synced to disk before it's renamed
+static bool config_file_write(const std::string& data)
 {
     std::string error;
-    m64p_error ret;
+    std::error_code errorCode;
+    bool ret;
 
-    l_sectionList.clear();
-
-    ret = m64p::Config.ListSections(nullptr, &config_listsections_callback);
-    if (ret != M64ERR_SUCCESS)
+    const char* configPath = m64p::Config.GetUserConfigPath();
+    if (configPath == nullptr)
     {
-        error = "config_section_exists m64p::Config.ListSections Failed: ";
-        error += m64p::Core.ErrorMessage(ret);
+        CoreSetError("config_file_write m64p::Config.GetUserConfigPath Failed!");
         return false;
     }
 
-    return std::find(l_sectionList.begin(), l_sectionList.end(), section) != l_sectionList.end();
-}
-
-static bool config_section_open(std::string section)
-{
-    std::string error;
-    m64p_error ret;
+    std::filesystem::path filePath = std::filesystem::path(configPath) / CONFIG_FILE_NAME;
+    std::filesystem::path tmpFilePath = filePath;
+#ifdef _WIN32
+    tmpFilePath += "." + std::to_string(_getpid()) + ".tmp";
+#else
+    tmpFilePath += "." + std::to_string(getpid()) + ".tmp";
+#endif // _WIN32
 
-    if (section.empty())
+    FILE* fileHandle = std::fopen(tmpFilePath.string().c_str(), "wb");
+    if (fileHandle == nullptr)
     {
-        error = "config_section_open Failed: cannot open empty section!";
+        error = "config_file_write Failed: cannot open ";
+        error += tmpFilePath.string();
         CoreSetError(error);
         return false;
     }
 
-    ret = m64p::Config.OpenSection(section.c_str(), &l_sectionHandle);
-    if (ret != M64ERR_SUCCESS)
+    ret = std::fwrite(data.data(), 1, data.size(), fileHandle) == data.size() &&
+          std::fflush(fileHandle) == 0;
+#ifdef _WIN32
+    ret = ret && _commit(_fileno(fileHandle)) == 0;
+#else
+    ret = ret && fsync(fileno(fileHandle)) == 0;
+#endif // _WIN32
+    ret = (std::fclose(fileHandle) == 0) && ret;
+
+    if (!ret)
     {
-        error = "config_section_open Failed: ";
-        error = m64p::Core.ErrorMessage(ret);
+        error = "config_file_write Failed: cannot write ";
+        error += tmpFilePath.string();
         CoreSetError(error);
+        std::filesystem::remove(tmpFilePath, errorCode);
+        return false;
     }
 
-    return ret == M64ERR_SUCCESS;
-}
-
-static bool config_option_set(std::string section, std::string key, m64p_type type, void *value)
-{
-    std::string error;
-    m64p_error ret;
+    std::filesystem::rename(tmpFilePath, filePath, errorCode);
+    if (errorCode)
+    {
+        error = "config_file_write std::filesystem::rename Failed: ";
+        error += errorCode.message();
+        CoreSetError(error);
+        std::filesystem::remove(tmpFilePath, errorCode);
+        return false;
+    }
 
-    if (!config_section_open(section))
+#ifndef _WIN32
+    // sync the directory so the rename itself is
+    // on disk too, not every file system supports
+    // syncing directories so EINVAL is ignored
+    int directoryHandle = open(configPath, O_RDONLY);
+    if (directoryHandle == -1)
     {
+        error = "config_file_write Failed: cannot open ";
+        error += configPath;
+        CoreSetError(error);
         return false;
     }
 
-    ret = m64p::Config.SetParameter(l_sectionHandle, key.c_str(), type, value);
-    if (ret != M64ERR_SUCCESS)
+    ret = fsync(directoryHandle) == 0 || errno == EINVAL;
+    close(directoryHandle);
+
+    if (!ret)
     {
-        error = "config_option_set m64p::Config.SetParameter Failed: ";
-        error += m64p::Core.ErrorMessage(ret);
+        error = "config_file_write Failed: cannot sync ";
+        error += configPath;
         CoreSetError(error);
+        return false;
     }
+#endif // _WIN32
 
-    return ret == M64ERR_SUCCESS;
+    return true;
 }
 
-static bool config_option_get(std::string section, std::string key, m64p_type type, void *value, int size)
+// serializes the settings when they've changed,
+// changes which the core or plugins made with
+// ConfigSetParameter() are picked up by
+// CoreSettingsInvalidate() at the points where
+// they can happen, l_settingsMutex must be locked
+static bool settings_serialize(std::string& data, bool& changed)
 {
-    std::string error;
-    m64p_error ret;
+    changed = l_settingsDirty && l_settingsFileOwner;
+    if (!changed)
+    {
+        return true;
+    }
 
-    if (!config_section_exists(section))
+    if (!config_file_serialize(data))
     {
-        error = "config_option_get Failed: cannot open non-existent section!";
-        CoreSetError(error);
+        changed = false;
         return false;
     }
 
-    if (!config_section_open(section))
+    l_settingsDirty = false;
+    return true;
+}
+
+// writes the serialized settings to disk, only
+// touches the file, so it's safe to call from
+// the writer thread, data is skipped when it's
+// identical to what has been written before,
+// calls are serialized by l_writer.busy
+static bool settings_write(const std::string* data)
+{
+    if (!CoreGameSettingsFlush())
     {
         return false;
     }
 
-    ret = m64p::Config.GetParameter(l_sectionHandle, key.c_str(), type, value, size);
-    if (ret != M64ERR_SUCCESS)
+    if (data == nullptr)
     {
-        error = "config_option_get m64p::Config.GetParameter Failed: ";
-        error += m64p::Core.ErrorMessage(ret);
-        CoreSetError(error);
+        return true;
     }
 
-    return ret == M64ERR_SUCCESS;
+    size_t dataHash = std::hash<std::string>{}(*data);
+    if (l_settingsWritten && l_settingsWrittenHash == dataHash)
+    {
+        return true;
+    }
+
+    if (!config_file_write(*data))
+    {
+        // serialize again next time
+        std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+        l_settingsDirty = true;
+        return false;
+    }
+
+    l_settingsWritten = true;
+    l_settingsWrittenHash = dataHash;
+    return true;
 }
 
-static bool config_option_default_set(std::string section, std::string key, m64p_type type, void *value, const char* description)
+// serializes the changed settings and writes
+// them to disk, the settings are only locked
+// while they're serialized
+static bool settings_serialize_write(void)
 {
-    std::string error;
-    m64p_error ret;
+    std::string data;
+    bool changed;
+    bool ret;
 
-    if (!config_section_open(section))
     {
-        return false;
+        std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+
+        // CoreSettingsCommitBatch() requests
+        // a new save when the batch is done
+        if (l_batchDepth > 0)
+        {
+            return true;
+        }
+
+        ret = settings_serialize(data, changed);
     }
 
-    switch (type)
+    return settings_write(changed ? &data : nullptr) && ret;
+}
+
+static void settings_writer_thread(void)
+{
+    std::unique_lock<std::mutex> lock(l_writerMutex);
+
+    while (!l_writer.stop)
     {
-        default:
-        {
-            ret = M64ERR_INPUT_INVALID;
-            error = "config_option_default_set Failed: invalid type parameter!";
-        } break;
-        case M64TYPE_INT:
-        {
-            ret = m64p::Config.SetDefaultInt(l_sectionHandle, key.c_str(), *(int*)value, description);
-            error = "config_option_default_set m64p::Config.SetDefaultInt Failed: ";
-            error += m64p::Core.ErrorMessage(ret);
-        } break;
-        case M64TYPE_BOOL:
+        l_writer.condition.wait(lock, []
         {
-            ret = m64p::Config.SetDefaultBool(l_sectionHandle, key.c_str(), *(bool*)value, description);
-            error = "config_option_default_set m64p::Config.SetDefaultBool Failed: ";
-            error += m64p::Core.ErrorMessage(ret);
-        } break;
-        case M64TYPE_FLOAT:
+            return l_writer.pending || l_writer.stop;
+        });
+
+        // wait until no save has been requested for
+        // SETTINGS_WRITE_DELAY, so consecutive saves
+        // are coalesced into a single write
+        while (!l_writer.stop && 
+                std::chrono::steady_clock::now() < l_writer.deadline)
         {
-            ret = m64p::Config.SetDefaultFloat(l_sectionHandle, key.c_str(), *(float*)value, description);
-            error = "config_option_default_set m64p::Config.SetDefaultFloat Failed: ";
-            error += m64p::Core.ErrorMessage(ret);
-        } break;
-        case M64TYPE_STRING:
+            l_writer.condition.wait_until(lock, l_writer.deadline);
+        }
+
+        if (l_writer.stop || !l_writer.pending)
         {
-            ret = m64p::Config.SetDefaultString(l_sectionHandle, key.c_str(), (char*)value, description);
-            error = "config_option_default_set m64p::Config.SetDefaultString Failed: ";
-            error += m64p::Core.ErrorMessage(ret);
-        } break;
+            continue;
+        }
+
+        l_writer.pending = false;
+        l_writer.busy = true;
+        lock.unlock();
+
+        settings_serialize_write();
+
+        lock.lock();
+        l_writer.busy = false;
+        l_writer.condition.notify_all();
     }
+}
 
-    if (ret != M64ERR_SUCCESS)
+// requests the writer thread to save
+// the settings after SETTINGS_WRITE_DELAY
+static void settings_writer_request(void)
+{
+    std::lock_guard<std::mutex> lock(l_writerMutex);
+
+    if (!l_writer.thread.joinable())
     {
-        CoreSetError(error);
+        l_writer.stop = false;
+        l_writer.thread = std::thread(settings_writer_thread);
     }
 
-    return ret == M64ERR_SUCCESS;
+    l_writer.pending = true;
+    l_writer.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SETTINGS_WRITE_DELAY);
+    l_writer.condition.notify_all();
 }
 
 //
@@ -505,30 +1183,98 @@ static bool config_option_default_set(std::string section, std::string key, m64p
 
 bool CoreSettingsSave(void)
 {
-    std::string error;
-    m64p_error ret;
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
 
-    ret = m64p::Config.SaveFile();
-    if (ret != M64ERR_SUCCESS)
+    // saving is deferred to CoreSettingsCommitBatch()
+    if (l_batchDepth > 0)
     {
-        error = "CoreSettingsSave m64p::Config.SaveFile Failed: ";
-        error += m64p::Core.ErrorMessage(ret);
-        CoreSetError(error);
+        return true;
     }
 
-    return ret == M64ERR_SUCCESS;
+    settings_writer_request();
+    return true;
+}
+
+bool CoreSettingsFlush(void)
+{
+    bool ret;
+
+    {
+        std::unique_lock<std::mutex> lock(l_writerMutex);
+
+        // cancel the pending request and
+        // wait for an ongoing write to finish
+        l_writer.pending = false;
+        l_writer.condition.wait(lock, []
+        {
+            return !l_writer.busy;
+        });
+        l_writer.busy = true;
+    }
+
+    ret = settings_serialize_write();
+
+    {
+        std::lock_guard<std::mutex> lock(l_writerMutex);
+        l_writer.busy = false;
+        l_writer.condition.notify_all();
+    }
+
+    return ret;
+}
+
+void CoreSettingsBeginBatch(void)
+{
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    l_batchDepth++;
+}
+
+bool CoreSettingsCommitBatch(void)
+{
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+
+    if (l_batchDepth > 0)
+    {
+        l_batchDepth--;
+    }
+
+    return CoreSettingsSave();
+}
+
+void CoreSettingsSetFileOwner(void)
+{
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    l_settingsFileOwner = true;
+}
+
+void CoreSettingsInvalidate(void)
+{
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    l_settingsDirty = true;
+    l_sectionData.clear();
+
+    // the cached values might be outdated
+    for (int i = 0; i < (int)SettingsID::Invalid; i++)
+    {
+        l_cachedValues[i] = l_CachedValue();
+        CoreSettingsNotifyChanged((SettingsID)i);
+    }
+}
+
+std::recursive_mutex& CoreSettingsGetMutex(void)
+{
+    return l_settingsMutex;
 }
 
 bool CoreSettingsSetupDefaults(void)
 {
-    l_Setting setting;
     bool ret, hasForceUsedSetOnce;
 
     hasForceUsedSetOnce = CoreSettingsGetBoolValue(SettingsID::Settings_HasForceUsedSetOnce);
 
     for (int i = 0; i < (int)SettingsID::Invalid; i++)
     {
-        setting = get_setting((SettingsID)i);
+        const l_Setting& setting = get_setting((SettingsID)i);
 
         if (setting.Section.empty())
         {
@@ -539,23 +1285,24 @@ bool CoreSettingsSetupDefaults(void)
         {
         case M64TYPE_STRING:
         {
+            std::string value = get_default_string(setting);
             if (setting.ForceUseSetOnce && !hasForceUsedSetOnce)
             {
-                ret = config_option_set(setting.Section, setting.Key, M64TYPE_STRING, (void*)setting.DefaultValue.stringValue.c_str());
+                ret = config_option_set(setting.Section, setting.Key, M64TYPE_STRING, (void*)value.c_str());
             }
             else if (!setting.ForceUseSetOnce)
             {
-                ret = config_option_default_set(setting.Section, setting.Key, M64TYPE_STRING, (void*)setting.DefaultValue.stringValue.c_str(), setting.Description.c_str());
+                ret = config_option_default_set(setting.Section, setting.Key, M64TYPE_STRING, value.c_str(), setting.Description.data());
             }
         } break;
         case M64TYPE_INT:
-            ret = config_option_default_set(setting.Section, setting.Key, M64TYPE_INT, &setting.DefaultValue.intValue, setting.Description.c_str());
+            ret = config_option_default_set(setting.Section, setting.Key, M64TYPE_INT, &setting.DefaultValue.intValue, setting.Description.data());
             break;
         case M64TYPE_BOOL:
-            ret = config_option_default_set(setting.Section, setting.Key, M64TYPE_BOOL, &setting.DefaultValue.boolValue, setting.Description.c_str());
+            ret = config_option_default_set(setting.Section, setting.Key, M64TYPE_BOOL, &setting.DefaultValue.boolValue, setting.Description.data());
             break;
         case M64TYPE_FLOAT:
-            ret = config_option_default_set(setting.Section, setting.Key, M64TYPE_FLOAT, &setting.DefaultValue.intValue, setting.Description.c_str());
+            ret = config_option_default_set(setting.Section, setting.Key, M64TYPE_FLOAT, &setting.DefaultValue.floatValue, setting.Description.data());
             break;
         }
 
@@ -575,173 +1322,352 @@ bool CoreSettingsSetupDefaults(void)
 
 bool CoreSettingsSectionExists(std::string section)
 {
+    if (is_game_section(section))
+    {
+        return game_settings_open() && CoreGameSettingsHasSection(section);
+    }
+
     return config_section_exists(section);
 }
 
 bool CoreSettingsDeleteSection(std::string section)
 {
-    std::string error;
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
     m64p_error ret;
 
+    if (is_game_section(section))
+    {
+        return game_settings_open() && CoreGameSettingsDeleteSection(section);
+    }
+
     if (!config_section_exists(section))
     {
-        error = "CoreSettingsDeleteSection Failed: cannot non-existent section!";
-        CoreSetError(error);
+        CoreSetError("CoreSettingsDeleteSection Failed: cannot non-existent section!");
         return false;
     }
 
     ret = m64p::Config.DeleteSection(section.c_str());
     if (ret != M64ERR_SUCCESS)
     {
-        error = "CoreSettingsDeleteSection m64p::Config.DeleteSection() Failed: ";
-        error = m64p::Core.ErrorMessage(ret);
-        CoreSetError(error);
+        CoreSetError("CoreSettingsDeleteSection m64p::Config.DeleteSection() Failed: ", m64p::Core.ErrorMessage(ret));
+    }
+    else
+    {
+        mark_section_dirty(section);
     }
 
+    // the handle is invalid now
+    l_sectionList.erase(section);
+    l_sectionHandles.erase(section);
+    invalidate_cached_values(section);
+
     return ret == M64ERR_SUCCESS;
 }
 
 bool CoreSettingsSetValue(SettingsID settingId, int value)
 {
-    l_Setting setting = get_setting(settingId);
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    const l_Setting& setting = get_setting(settingId);
+    l_CachedValue* cachedValue = get_cached_value(settingId);
+
+    // skip writing unchanged values
+    if (cachedValue != nullptr && cachedValue->IntValid && cachedValue->IntValue == value)
+    {
+        return true;
+    }
+
     return config_option_set(setting.Section, setting.Key, M64TYPE_INT, &value);
 }
 
 bool CoreSettingsSetValue(SettingsID settingId, bool value)
 {
-    l_Setting setting = get_setting(settingId);
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    const l_Setting& setting = get_setting(settingId);
+    l_CachedValue* cachedValue = get_cached_value(settingId);
+
+    // skip writing unchanged values
+    if (cachedValue != nullptr && cachedValue->BoolValid && cachedValue->BoolValue == value)
+    {
+        return true;
+    }
+
     return config_option_set(setting.Section, setting.Key, M64TYPE_BOOL, &value);
 }
 
 bool CoreSettingsSetValue(SettingsID settingId, float value)
 {
-    l_Setting setting = get_setting(settingId);
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    const l_Setting& setting = get_setting(settingId);
+    l_CachedValue* cachedValue = get_cached_value(settingId);
+
+    // skip writing unchanged values
+    if (cachedValue != nullptr && cachedValue->FloatValid && cachedValue->FloatValue == value)
+    {
+        return true;
+    }
+
     return config_option_set(setting.Section, setting.Key, M64TYPE_FLOAT, &value);
 }
 
 bool CoreSettingsSetValue(SettingsID settingId, std::string value)
 {
-    l_Setting setting = get_setting(settingId);
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    const l_Setting& setting = get_setting(settingId);
+    l_CachedValue* cachedValue = get_cached_value(settingId);
+
+    // skip writing unchanged values
+    if (cachedValue != nullptr && cachedValue->StringValid && cachedValue->StringValue == value)
+    {
+        return true;
+    }
+
     return config_option_set(setting.Section, setting.Key, M64TYPE_STRING, (void*)value.c_str());
 }
 
 bool CoreSettingsSetValue(SettingsID settingId, std::vector<int> value)
 {
-    std::string value_str;
-    for (const int& num : value)
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    l_CachedValue* cachedValue = get_cached_value(settingId);
+
+    // skip writing unchanged values
+    if (cachedValue != nullptr && cachedValue->IntListValid && cachedValue->IntListValue == value)
+    {
+        return true;
+    }
+
+    return CoreSettingsSetValue(settingId, int_list_to_string(value.data(), value.size()));
+}
+
+bool CoreSettingsSetValue(SettingsID settingId, std::vector<char> value)
+{
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    l_CachedValue* cachedValue = get_cached_value(settingId);
+
+    // skip writing unchanged values
+    if (cachedValue != nullptr && cachedValue->BlobValid && cachedValue->BlobValue == value)
     {
-        value_str += std::to_string(num);
-        value_str += ";";
+        return true;
     }
-    return CoreSettingsSetValue(settingId, value_str);
+
+    return CoreSettingsSetValue(settingId, blob_to_string(value));
 }
 
 bool CoreSettingsSetValue(SettingsID settingId, std::string section, int value)
 {
-    l_Setting setting = get_setting(settingId);
+    const l_Setting& setting = get_setting(settingId);
     return config_option_set(section, setting.Key, M64TYPE_INT, &value);
 }
 
 bool CoreSettingsSetValue(SettingsID settingId, std::string section, bool value)
 {
-    l_Setting setting = get_setting(settingId);
+    const l_Setting& setting = get_setting(settingId);
     return config_option_set(section, setting.Key, M64TYPE_BOOL, &value);
 }
 
 bool CoreSettingsSetValue(SettingsID settingId, std::string section, float value)
 {
-    l_Setting setting = get_setting(settingId);
+    const l_Setting& setting = get_setting(settingId);
     return config_option_set(section, setting.Key, M64TYPE_FLOAT, &value);
 }
 
 bool CoreSettingsSetValue(SettingsID settingId, std::string section, std::string value)
 {
-    l_Setting setting = get_setting(settingId);
+    const l_Setting& setting = get_setting(settingId);
     return config_option_set(section, setting.Key, M64TYPE_STRING, (void*)value.c_str());
 }
 
 bool CoreSettingsSetValue(SettingsID settingId, std::string section, std::vector<int> value)
 {
-    std::string value_str;
-    for (const int& num : value)
-    {
-        value_str += std::to_string(num);
-        value_str += ";";
-    }
-    return CoreSettingsSetValue(settingId, section, value_str);
+    return CoreSettingsSetValue(settingId, section, int_list_to_string(value.data(), value.size()));
+}
+
+bool CoreSettingsSetValue(SettingsID settingId, std::string section, std::vector<char> value)
+{
+    return CoreSettingsSetValue(settingId, section, blob_to_string(value));
 }
 
 int CoreSettingsGetDefaultIntValue(SettingsID settingId)
 {
-    l_Setting setting = get_setting(settingId);
+    const l_Setting& setting = get_setting(settingId);
     return setting.DefaultValue.intValue;
 }
 
 bool CoreSettingsGetDefaultBoolValue(SettingsID settingId)
 {
-    l_Setting setting = get_setting(settingId);
+    const l_Setting& setting = get_setting(settingId);
     return setting.DefaultValue.boolValue;
 }
 
 float CoreSettingsGetDefaultFloatValue(SettingsID settingId)
 {
-    l_Setting setting = get_setting(settingId);
+    const l_Setting& setting = get_setting(settingId);
     return setting.DefaultValue.floatValue;
 }
 
 std::string CoreSettingsGetDefaultStringValue(SettingsID settingId)
 {
-    l_Setting setting = get_setting(settingId);
-    return setting.DefaultValue.stringValue;
+    const l_Setting& setting = get_setting(settingId);
+    return get_default_string(setting);
 }
 
 std::vector<int> CoreSettingsGetDefaultIntListValue(SettingsID settingId)
 {
-    l_Setting setting = get_setting(settingId);
-    return setting.DefaultValue.intListValue;
+    const l_Setting& setting = get_setting(settingId);
+    const int* intList = setting.DefaultValue.intListValue;
+    return std::vector<int>(intList, intList + setting.DefaultValue.intListSize);
 }
 
 int CoreSettingsGetIntValue(SettingsID settingId)
 {
-    l_Setting setting = get_setting(settingId);
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    const l_Setting& setting = get_setting(settingId);
+    l_CachedValue* cachedValue = get_cached_value(settingId);
+
+    if (cachedValue != nullptr && cachedValue->IntValid)
+    {
+        return cachedValue->IntValue;
+    }
+
     int value = setting.DefaultValue.intValue;
-    config_option_get(setting.Section, setting.Key, M64TYPE_INT, &value, sizeof(value));
+    // failed reads return the default
+    // value, those aren't cached
+    if (config_option_get(setting.Section, setting.Key, M64TYPE_INT, &value, sizeof(value)) &&
+        cachedValue != nullptr)
+    {
+        cachedValue->IntValue = value;
+        cachedValue->IntValid = true;
+    }
+
     return value;
 }
 
 bool CoreSettingsGetBoolValue(SettingsID settingId)
 {
-    l_Setting setting = get_setting(settingId);
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    const l_Setting& setting = get_setting(settingId);
+    l_CachedValue* cachedValue = get_cached_value(settingId);
+
+    if (cachedValue != nullptr && cachedValue->BoolValid)
+    {
+        return cachedValue->BoolValue;
+    }
+
     int value = setting.DefaultValue.boolValue;
-    config_option_get(setting.Section, setting.Key, M64TYPE_BOOL, &value, sizeof(value));
+    // failed reads return the default
+    // value, those aren't cached
+    if (config_option_get(setting.Section, setting.Key, M64TYPE_BOOL, &value, sizeof(value)) &&
+        cachedValue != nullptr)
+    {
+        cachedValue->BoolValue = value;
+        cachedValue->BoolValid = true;
+    }
+
     return value;
 }
 
 float CoreSettingsGetFloatValue(SettingsID settingId)
 {
-    l_Setting setting = get_setting(settingId);
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    const l_Setting& setting = get_setting(settingId);
+    l_CachedValue* cachedValue = get_cached_value(settingId);
+
+    if (cachedValue != nullptr && cachedValue->FloatValid)
+    {
+        return cachedValue->FloatValue;
+    }
+
     float value = setting.DefaultValue.floatValue;
-    config_option_get(setting.Section, setting.Key, M64TYPE_FLOAT, &value, sizeof(value));
+    // failed reads return the default
+    // value, those aren't cached
+    if (config_option_get(setting.Section, setting.Key, M64TYPE_FLOAT, &value, sizeof(value)) &&
+        cachedValue != nullptr)
+    {
+        cachedValue->FloatValue = value;
+        cachedValue->FloatValid = true;
+    }
+
     return value;
 }
 
-std::string CoreSettingsGetStringValue(SettingsID settingId)
+const std::string& CoreSettingsGetStringValue(SettingsID settingId)
 {
-    l_Setting setting = get_setting(settingId);
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    const l_Setting& setting = get_setting(settingId);
+    l_CachedValue* cachedValue = get_cached_value(settingId);
+
+    // returned when the value isn't cached
+    static thread_local std::string uncachedValue;
+
+    if (cachedValue != nullptr && cachedValue->StringValid)
+    {
+        return cachedValue->StringValue;
+    }
+
     char value[STR_SIZE] = {0};
-    config_option_get(setting.Section, setting.Key, M64TYPE_STRING, (char*)value, sizeof(value));
-    return std::string(value);
+    if (!config_option_get(setting.Section, setting.Key, M64TYPE_STRING, (char*)value, sizeof(value)) ||
+        cachedValue == nullptr)
+    {
+        uncachedValue = value;
+        return uncachedValue;
+    }
+
+    cachedValue->StringValue = value;
+    cachedValue->StringValid = true;
+    return cachedValue->StringValue;
+}
+
+const std::vector<int>& CoreSettingsGetIntListValue(SettingsID settingId)
+{
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    l_CachedValue* cachedValue = get_cached_value(settingId);
+
+    // returned when the value isn't cached
+    static thread_local std::vector<int> uncachedValue;
+
+    if (cachedValue != nullptr && cachedValue->IntListValid)
+    {
+        return cachedValue->IntListValue;
+    }
+
+    std::vector<int> value = string_to_int_list(CoreSettingsGetStringValue(settingId));
+
+    // only cache it when the string could be cached
+    if (cachedValue == nullptr || !cachedValue->StringValid)
+    {
+        uncachedValue = std::move(value);
+        return uncachedValue;
+    }
+
+    cachedValue->IntListValue = std::move(value);
+    cachedValue->IntListValid = true;
+    return cachedValue->IntListValue;
 }
 
-std::vector<int> CoreSettingsGetIntListValue(SettingsID settingId)
+std::vector<char> CoreSettingsGetBlobValue(SettingsID settingId)
 {
-    l_Setting setting = get_setting(settingId);
-    return CoreSettingsGetIntListValue(settingId, setting.Section);
+    std::lock_guard<std::recursive_mutex> lock(l_settingsMutex);
+    l_CachedValue* cachedValue = get_cached_value(settingId);
+
+    if (cachedValue != nullptr && cachedValue->BlobValid)
+    {
+        return cachedValue->BlobValue;
+    }
+
+    std::vector<char> value = string_to_blob(CoreSettingsGetStringValue(settingId));
+
+    // only cache it when the string could be cached
+    if (cachedValue != nullptr && cachedValue->StringValid)
+    {
+        cachedValue->BlobValue = value;
+        cachedValue->BlobValid = true;
+    }
+
+    return value;
 }
 
 int CoreSettingsGetIntValue(SettingsID settingId, std::string section)
 {
-    l_Setting setting = get_setting(settingId);
+    const l_Setting& setting = get_setting(settingId);
     int value = setting.DefaultValue.intValue;
     config_option_get(section, setting.Key, M64TYPE_INT, &value, sizeof(value));
     return value;
@@ -749,7 +1675,7 @@ int CoreSettingsGetIntValue(SettingsID settingId, std::string section)
 
 bool CoreSettingsGetBoolValue(SettingsID settingId, std::string section)
 {
-    l_Setting setting = get_setting(settingId);
+    const l_Setting& setting = get_setting(settingId);
     int value = setting.DefaultValue.boolValue;
     config_option_get(section, setting.Key, M64TYPE_BOOL, &value, sizeof(value));
     return value;
@@ -757,7 +1683,7 @@ bool CoreSettingsGetBoolValue(SettingsID settingId, std::string section)
 
 float CoreSettingsGetFloatValue(SettingsID settingId, std::string section)
 {
-    l_Setting setting = get_setting(settingId);
+    const l_Setting& setting = get_setting(settingId);
     float value = setting.DefaultValue.floatValue;
     config_option_get(section, setting.Key, M64TYPE_FLOAT, &value, sizeof(value));
     return value;
@@ -765,7 +1691,7 @@ float CoreSettingsGetFloatValue(SettingsID settingId, std::string section)
 
 std::string CoreSettingsGetStringValue(SettingsID settingId, std::string section)
 {
-    l_Setting setting = get_setting(settingId);
+    const l_Setting& setting = get_setting(settingId);
     char value[STR_SIZE] = {0};
     config_option_get(section, setting.Key, M64TYPE_STRING, (char*)value, sizeof(value));
     return std::string(value);
@@ -773,27 +1699,10 @@ std::string CoreSettingsGetStringValue(SettingsID settingId, std::string section
 
 std::vector<int> CoreSettingsGetIntListValue(SettingsID settingId, std::string section)
 {
-    l_Setting setting = get_setting(settingId);
-    std::vector<int> value;
-
-    std::string value_str;
-    value_str = CoreSettingsGetStringValue(settingId, section);
-
-    // split string by ';'
-    // and append list with each item
-    std::stringstream value_str_stream(value_str);
-    std::string tmp_str;
-    while (std::getline(value_str_stream, tmp_str, ';'))
-    {
-        try
-        {
-            value.emplace_back(std::stoi(tmp_str));
-        }
-        catch (std::exception)
-        { // ignore exception
-            continue;
-        }
-    }
+    return string_to_int_list(CoreSettingsGetStringValue(settingId, section));
+}
 
-    return value;
+std::vector<char> CoreSettingsGetBlobValue(SettingsID settingId, std::string section)
+{
+    return string_to_blob(CoreSettingsGetStringValue(settingId, section));
 }
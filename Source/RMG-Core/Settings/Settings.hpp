@@ -12,12 +12,41 @@
 
 #include "SettingsID.hpp"
 
+#include <functional>
+#include <mutex>
 #include <string>
 #include <vector>
 
-// saves settings to file
+// requests settings to be saved to file, after a short
+// delay the changed sections are serialized and the file
+// is written atomically on a background thread, only by
+// the copy of RMG-Core which started the core
 bool CoreSettingsSave(void);
 
+// saves settings to file immediately when
+// they've changed, waits for pending saves
+bool CoreSettingsFlush(void);
+
+// starts a batch of settings changes,
+// saving is deferred until the batch is committed
+void CoreSettingsBeginBatch(void);
+
+// commits a batch of settings changes
+// and saves them once, batches can be nested
+bool CoreSettingsCommitBatch(void);
+
+// subscribes callback to changes of settingId,
+// the callback is called on the subscribing thread
+// by CoreSettingsProcessEvents(), returns the subscription id
+int CoreSettingsSubscribe(SettingsID settingId, std::function<void(SettingsID)> callback);
+
+// removes subscription
+void CoreSettingsUnsubscribe(int subscriptionId);
+
+// calls the callbacks of the current thread's
+// subscriptions for settings which have changed
+void CoreSettingsProcessEvents(void);
+
 // setup default settings
 bool CoreSettingsSetupDefaults(void);
 
@@ -37,6 +66,8 @@ bool CoreSettingsSetValue(SettingsID settingId, float value);
 bool CoreSettingsSetValue(SettingsID settingId, std::string value);
 // sets setting as int list value
 bool CoreSettingsSetValue(SettingsID settingId, std::vector<int> value);
+// sets setting as blob value
+bool CoreSettingsSetValue(SettingsID settingId, std::vector<char> value);
 
 // sets setting in section as int value
 bool CoreSettingsSetValue(SettingsID settingId, std::string section, int value);
@@ -48,6 +79,8 @@ bool CoreSettingsSetValue(SettingsID settingId, std::string section, float value
 bool CoreSettingsSetValue(SettingsID settingId, std::string section, std::string value);
 // sets setting in section as int list value
 bool CoreSettingsSetValue(SettingsID settingId, std::string section, std::vector<int> value);
+// sets setting in section as blob value
+bool CoreSettingsSetValue(SettingsID settingId, std::string section, std::vector<char> value);
 
 // retrieves default setting as int
 int CoreSettingsGetDefaultIntValue(SettingsID settingId);
@@ -66,10 +99,16 @@ int CoreSettingsGetIntValue(SettingsID settingId);
 bool CoreSettingsGetBoolValue(SettingsID settingId);
 // retrieves setting as float
 float CoreSettingsGetFloatValue(SettingsID settingId);
-// retrieves setting as string
-std::string CoreSettingsGetStringValue(SettingsID settingId);
-// retrieves setting as int list
-std::vector<int> CoreSettingsGetIntListValue(SettingsID settingId);
+// retrieves setting as string, the returned reference
+// stays valid until the setting changes or this thread
+// retrieves another setting which can't be cached,
+// copy it when it's kept or used on another thread
+const std::string& CoreSettingsGetStringValue(SettingsID settingId);
+// retrieves setting as int list, the returned reference
+// stays valid like the one of CoreSettingsGetStringValue()
+const std::vector<int>& CoreSettingsGetIntListValue(SettingsID settingId);
+// retrieves setting as blob
+std::vector<char> CoreSettingsGetBlobValue(SettingsID settingId);
 
 // retrieves setting in section as int
 int CoreSettingsGetIntValue(SettingsID settingId, std::string section);
@@ -81,5 +120,28 @@ float CoreSettingsGetFloatValue(SettingsID settingId, std::string section);
 std::string CoreSettingsGetStringValue(SettingsID settingId, std::string section);
 // retrieves setting in section as int list
 std::vector<int>CoreSettingsGetIntListValue(SettingsID settingId, std::string section);
+// retrieves setting in section as blob
+std::vector<char> CoreSettingsGetBlobValue(SettingsID settingId, std::string section);
+
+// internal settings functions
+#ifdef CORE_INTERNAL
+
+// makes this copy of RMG-Core the owner of the
+// config file, only the owner writes it to disk
+// because plugins link their own copy
+void CoreSettingsSetFileOwner(void);
+
+// marks the settings as changed and drops the cached
+// values, called after the core or plugins might've
+// changed the config
+void CoreSettingsInvalidate(void);
+
+// returns the mutex which guards the core's
+// config, it has to be locked while plugins
+// can access the config on another thread,
+// lock the plugins mutex first when both are needed
+std::recursive_mutex& CoreSettingsGetMutex(void);
+
+#endif // CORE_INTERNAL
 
 #endif // CORE_SETTINGS_HPP
@@ -0,0 +1,191 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "SettingsEvents.hpp"
+#include "Settings.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//
+// Local Structures
+//
+
+struct l_SettingsEvent
+{
+    int SubscriptionId;
+    SettingsID SettingId;
+    l_SettingsEvent* Next;
+};
+
+// events queued for a single thread, events
+// are pushed without locking and taken all at
+// once by the thread when processing them
+struct l_SettingsMailbox
+{
+    std::atomic<l_SettingsEvent*> Head = nullptr;
+
+    ~l_SettingsMailbox(void)
+    {
+        l_SettingsEvent* event = this->Head.exchange(nullptr);
+        while (event != nullptr)
+        {
+            l_SettingsEvent* next = event->Next;
+            delete event;
+            event = next;
+        }
+    }
+};
+
+struct l_SettingsSubscription
+{
+    int Id;
+    SettingsID SettingId;
+    std::function<void(SettingsID)> Callback;
+    std::shared_ptr<l_SettingsMailbox> Mailbox;
+};
+
+using l_SettingsSubscriptions = std::vector<l_SettingsSubscription>;
+
+//
+// Local Variables
+//
+
+// the subscriptions are replaced as a whole when
+// they change, so notifying only has to load them
+static std::atomic<std::shared_ptr<const l_SettingsSubscriptions>> l_subscriptions = std::make_shared<const l_SettingsSubscriptions>();
+static std::mutex       l_subscriptionsMutex;
+static std::atomic<int> l_nextSubscriptionId = 1;
+
+static thread_local std::shared_ptr<l_SettingsMailbox> l_threadMailbox;
+
+//
+// Local Functions
+//
+
+static std::shared_ptr<l_SettingsMailbox> get_thread_mailbox(void)
+{
+    if (l_threadMailbox == nullptr)
+    {
+        l_threadMailbox = std::make_shared<l_SettingsMailbox>();
+    }
+
+    return l_threadMailbox;
+}
+
+static void mailbox_push(l_SettingsMailbox* mailbox, l_SettingsEvent* event)
+{
+    event->Next = mailbox->Head.load(std::memory_order_relaxed);
+    while (!mailbox->Head.compare_exchange_weak(event->Next, event,
+                std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+}
+
+//
+// Exported Functions
+//
+
+void CoreSettingsNotifyChanged(SettingsID settingId)
+{
+    std::shared_ptr<const l_SettingsSubscriptions> subscriptions = l_subscriptions.load();
+
+    for (const l_SettingsSubscription& subscription : *subscriptions)
+    {
+        if (subscription.SettingId != settingId)
+        {
+            continue;
+        }
+
+        mailbox_push(subscription.Mailbox.get(), new l_SettingsEvent{subscription.Id, settingId, nullptr});
+    }
+}
+
+int CoreSettingsSubscribe(SettingsID settingId, std::function<void(SettingsID)> callback)
+{
+    std::lock_guard<std::mutex> lock(l_subscriptionsMutex);
+
+    int id = l_nextSubscriptionId++;
+
+    auto subscriptions = std::make_shared<l_SettingsSubscriptions>(*l_subscriptions.load());
+    subscriptions->push_back({id, settingId, callback, get_thread_mailbox()});
+    l_subscriptions.store(subscriptions);
+
+    return id;
+}
+
+void CoreSettingsUnsubscribe(int subscriptionId)
+{
+    std::lock_guard<std::mutex> lock(l_subscriptionsMutex);
+
+    auto subscriptions = std::make_shared<l_SettingsSubscriptions>(*l_subscriptions.load());
+    std::erase_if(*subscriptions, [subscriptionId](const l_SettingsSubscription& subscription)
+    {
+        return subscription.Id == subscriptionId;
+    });
+    l_subscriptions.store(subscriptions);
+}
+
+void CoreSettingsProcessEvents(void)
+{
+    if (l_threadMailbox == nullptr)
+    {
+        return;
+    }
+
+    l_SettingsEvent* event = l_threadMailbox->Head.exchange(nullptr, std::memory_order_acquire);
+    if (event == nullptr)
+    {
+        return;
+    }
+
+    // events are pushed in reverse order,
+    // so reverse them before dispatching
+    l_SettingsEvent* events = nullptr;
+    while (event != nullptr)
+    {
+        l_SettingsEvent* next = event->Next;
+        event->Next = events;
+        events = event;
+        event = next;
+    }
+
+    std::shared_ptr<const l_SettingsSubscriptions> subscriptions = l_subscriptions.load();
+    std::vector<int> dispatched;
+
+    event = events;
+    while (event != nullptr)
+    {
+        l_SettingsEvent* next = event->Next;
+
+        // only dispatch the first event for each subscription,
+        // the callback retrieves the current value anyway
+        if (std::find(dispatched.begin(), dispatched.end(), event->SubscriptionId) == dispatched.end())
+        {
+            dispatched.push_back(event->SubscriptionId);
+
+            // the subscription may have been
+            // removed after the event was queued
+            for (const l_SettingsSubscription& subscription : *subscriptions)
+            {
+                if (subscription.Id == event->SubscriptionId)
+                {
+                    subscription.Callback(event->SettingId);
+                    break;
+                }
+            }
+        }
+
+        delete event;
+        event = next;
+    }
+}
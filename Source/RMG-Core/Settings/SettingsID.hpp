@@ -1,98 +1,128 @@
 #ifndef CORE_SETTINGSID_HPP
 #define CORE_SETTINGSID_HPP
 
+// list of all settings, each entry is
+// SETTING(id, section, key, default value),
+// the sections and platform specific defaults
+// are defined in Settings.cpp, settings using
+// SETTING_SET_ONCE are only set once instead
+// of being set as default value
+#define SETTINGS_LIST(SETTING, SETTING_SET_ONCE)                                                                        \
+    /* GUI Settings */                                                                                                  \
+    SETTING(GUI_SettingsDialogWidth, SETTING_SECTION_GUI, "SettingsDialogWidth", 0)                                     \
+    SETTING(GUI_SettingsDialogHeight, SETTING_SECTION_GUI, "SettingsDialogHeight", 0)                                   \
+    SETTING(GUI_AllowManualResizing, SETTING_SECTION_GUI, "AllowManualResizing", true)                                  \
+    SETTING(GUI_HideCursorInEmulation, SETTING_SECTION_GUI, "HideCursorInEmulation", false)                             \
+    SETTING(GUI_StatusbarMessageDuration, SETTING_SECTION_GUI, "StatusbarMessageDuration", 3)                           \
+    SETTING(GUI_RecordingDirectory, SETTING_SECTION_GUI, "RecordingDirectory", "Recordings")                            \
+    SETTING(GUI_FullscreenScreen, SETTING_SECTION_GUI, "FullscreenScreen", "")                                          \
+    SETTING(GUI_ThreadedPresent, SETTING_SECTION_GUI, "ThreadedPresent", false)                                         \
+                                                                                                                        \
+    /* Core Plugin Settings */                                                                                          \
+    SETTING(Core_GFX_Plugin, SETTING_SECTION_CORE, "GFX_Plugin", SETTING_DEFAULT_GFX_PLUGIN)                            \
+    SETTING(Core_AUDIO_Plugin, SETTING_SECTION_CORE, "AUDIO_Plugin", SETTING_DEFAULT_AUDIO_PLUGIN)                      \
+    SETTING(Core_INPUT_Plugin, SETTING_SECTION_CORE, "INPUT_Plugin", SETTING_DEFAULT_INPUT_PLUGIN)                      \
+    SETTING(Core_RSP_Plugin, SETTING_SECTION_CORE, "RSP_Plugin", SETTING_DEFAULT_RSP_PLUGIN)                            \
+                                                                                                                        \
+    /* Core User Directory Settings */                                                                                  \
+    SETTING(Core_OverrideUserDirs, SETTING_SECTION_CORE, "OverrideUserDirectories", true)                               \
+    SETTING(Core_UserDataDirOverride, SETTING_SECTION_CORE, "UserDataDirectory", "Data")                                \
+    SETTING(Core_UserCacheDirOverride, SETTING_SECTION_CORE, "UserCacheDirectory", "Cache")                             \
+                                                                                                                        \
+    /* Core 64DD ROM Settings */                                                                                        \
+    SETTING(Core_64DD_RomFile, SETTING_SECTION_CORE, "64DD_RomFile", "")                                                \
+                                                                                                                        \
+    /* Core Rewind Settings */                                                                                          \
+    SETTING(Core_RewindEnabled, SETTING_SECTION_CORE, "RewindEnabled", false)                                           \
+    SETTING(Core_RewindBufferSize, SETTING_SECTION_CORE, "RewindBufferSize", 64)                                        \
+    SETTING(Core_RewindInterval, SETTING_SECTION_CORE, "RewindInterval", 2)                                             \
+                                                                                                                        \
+    /* Core Speed Settings */                                                                                           \
+    SETTING(Core_FastForwardSpeed, SETTING_SECTION_CORE, "FastForwardSpeed", 300)                                       \
+    SETTING(Core_SlowMotionSpeed, SETTING_SECTION_CORE, "SlowMotionSpeed", 50)                                          \
+                                                                                                                        \
+    /* (mupen64plus) Core Settings */                                                                                   \
+    SETTING(Core_OverrideGameSpecificSettings, SETTING_SECTION_CORE, "OverrideGameSpecificSettings", false)             \
+    SETTING(Core_RandomizeInterrupt, SETTING_SECTION_OVERLAY, "RandomizeInterrupt", true)                               \
+    SETTING(Core_CPU_Emulator, SETTING_SECTION_OVERLAY, "CPU_Emulator", 2)                                              \
+    SETTING(Core_DisableExtraMem, SETTING_SECTION_OVERLAY, "DisableExtraMem", false)                                    \
+    SETTING(Core_EnableDebugger, SETTING_SECTION_OVERLAY, "EnableDebugger", false)                                      \
+    SETTING(Core_CountPerOp, SETTING_SECTION_OVERLAY, "CountPerOp", 0)                                                  \
+    SETTING(Core_SiDmaDuration, SETTING_SECTION_OVERLAY, "SiDmaDuration", -1)                                           \
+                                                                                                                        \
+    /* (mupen64plus) Core Directory Settings */                                                                         \
+    SETTING_SET_ONCE(Core_ScreenshotPath, SETTING_SECTION_M64P, "ScreenshotPath", "Screenshots")                        \
+    SETTING_SET_ONCE(Core_SaveStatePath, SETTING_SECTION_M64P, "SaveStatePath", "Save/State")                           \
+    SETTING_SET_ONCE(Core_SaveSRAMPath, SETTING_SECTION_M64P, "SaveSRAMPath", "Save/Game")                              \
+    SETTING_SET_ONCE(Core_SharedDataPath, SETTING_SECTION_M64P, "SharedDataPath", "Data")                               \
+                                                                                                                        \
+    /* Game Specific Settings */                                                                                        \
+    SETTING(Game_DisableExtraMem, SETTING_SECTION_GAME, "DisableExtraMem", false)                                       \
+    SETTING(Game_SaveType, SETTING_SECTION_GAME, "SaveType", 0)                                                         \
+    SETTING(Game_CountPerOp, SETTING_SECTION_GAME, "CountPerOp", 2)                                                     \
+    SETTING(Game_SiDmaDuration, SETTING_SECTION_GAME, "SiDmaDuration", 2304)                                            \
+                                                                                                                        \
+    /* Game Core Override Settings */                                                                                   \
+    SETTING(Game_OverrideCoreSettings, SETTING_SECTION_GAME, "OverrideCoreSettings", false)                             \
+    SETTING(Game_CPU_Emulator, SETTING_SECTION_GAME, "CPU_Emulator", 2)                                                 \
+    SETTING(Game_RandomizeInterrupt, SETTING_SECTION_GAME, "RandomizeInterrupt", true)                                  \
+                                                                                                                        \
+    /* Game Run-Ahead Settings */                                                                                       \
+    SETTING(Game_RunAheadFrames, SETTING_SECTION_GAME, "RunAheadFrames", 0)                                             \
+                                                                                                                        \
+    /* Game Plugin Settings */                                                                                          \
+    SETTING(Game_GFX_Plugin, SETTING_SECTION_GAME, "GFX_Plugin", "")                                                    \
+    SETTING(Game_AUDIO_Plugin, SETTING_SECTION_GAME, "AUDIO_Plugin", "")                                                \
+    SETTING(Game_INPUT_Plugin, SETTING_SECTION_GAME, "INPUT_Plugin", "")                                                \
+    SETTING(Game_RSP_Plugin, SETTING_SECTION_GAME, "RSP_Plugin", "")                                                    \
+                                                                                                                        \
+    /* GUI KeyBindings */                                                                                               \
+    SETTING(KeyBinding_OpenROM, SETTING_SECTION_KEYBIND, "OpenROM", "Ctrl+O")                                           \
+    SETTING(KeyBinding_OpenCombo, SETTING_SECTION_KEYBIND, "OpenCombo", "Ctrl+Shift+O")                                 \
+    SETTING(KeyBinding_StartEmulation, SETTING_SECTION_KEYBIND, "StartEmulation", "F11")                                \
+    SETTING(KeyBinding_EndEmulation, SETTING_SECTION_KEYBIND, "EndEmulation", "F12")                                    \
+    SETTING(KeyBinding_RefreshROMList, SETTING_SECTION_KEYBIND, "RefreshROMList", "F5")                                 \
+    SETTING(KeyBinding_Exit, SETTING_SECTION_KEYBIND, "Exit", "Alt+F4")                                                 \
+    SETTING(KeyBinding_SoftReset, SETTING_SECTION_KEYBIND, "SoftReset", "F1")                                           \
+    SETTING(KeyBinding_HardReset, SETTING_SECTION_KEYBIND, "HardReset", "Shift+F1")                                     \
+    SETTING(KeyBinding_Resume, SETTING_SECTION_KEYBIND, "Resume", "F2")                                                 \
+    SETTING(KeyBinding_GenerateBitmap, SETTING_SECTION_KEYBIND, "GenerateBitmap", "F3")                                 \
+    SETTING(KeyBinding_RecordVideo, SETTING_SECTION_KEYBIND, "RecordVideo", "Ctrl+R")                                   \
+    SETTING(KeyBinding_LimitFPS, SETTING_SECTION_KEYBIND, "LimitFPS", "F4")                                             \
+    SETTING(KeyBinding_SwapDisk, SETTING_SECTION_KEYBIND, "SwapDisk", "Ctrl+D")                                         \
+    SETTING(KeyBinding_SaveState, SETTING_SECTION_KEYBIND, "SaveState", "F5")                                           \
+    SETTING(KeyBinding_SaveAs, SETTING_SECTION_KEYBIND, "SaveAs", "Ctrl+S")                                             \
+    SETTING(KeyBinding_LoadState, SETTING_SECTION_KEYBIND, "LoadState", "F7")                                           \
+    SETTING(KeyBinding_Load, SETTING_SECTION_KEYBIND, "Load", "Ctrl+L")                                                 \
+    SETTING(KeyBinding_Cheats, SETTING_SECTION_KEYBIND, "Cheats", "Ctrl+C")                                             \
+    SETTING(KeyBinding_GSButton, SETTING_SECTION_KEYBIND, "GSButton", "F9")                                             \
+    SETTING(KeyBinding_Fullscreen, SETTING_SECTION_KEYBIND, "Fullscreen", "Alt+Return")                                 \
+    SETTING(KeyBinding_Settings, SETTING_SECTION_KEYBIND, "Settings", "Ctrl+T")                                         \
+    SETTING(KeyBinding_Rewind, SETTING_SECTION_KEYBIND, "Rewind", "Backspace")                                          \
+    SETTING(KeyBinding_FastForwardHold, SETTING_SECTION_KEYBIND, "FastForwardHold", "Tab")                              \
+    SETTING(KeyBinding_FastForwardToggle, SETTING_SECTION_KEYBIND, "FastForwardToggle", "Ctrl+F")                       \
+    SETTING(KeyBinding_SlowMotionToggle, SETTING_SECTION_KEYBIND, "SlowMotionToggle", "Ctrl+M")                         \
+                                                                                                                        \
+    /* RomBrowser Settings */                                                                                           \
+    SETTING(RomBrowser_Directory, SETTING_SECTION_ROMBROWSER, "Directory", "")                                          \
+    SETTING(RomBrowser_Geometry, SETTING_SECTION_ROMBROWSER, "Geometry", "")                                            \
+    SETTING(RomBrowser_Recursive, SETTING_SECTION_ROMBROWSER, "Recursive", true)                                        \
+    SETTING(RomBrowser_MaxItems, SETTING_SECTION_ROMBROWSER, "MaxItems", 50)                                            \
+    SETTING(RomBrowser_Columns, SETTING_SECTION_ROMBROWSER, "Columns", SETTING_INTLIST(0, 1, 2))                        \
+    SETTING(RomBrowser_ColumnSizes, SETTING_SECTION_ROMBROWSER, "ColumnSizes", SETTING_INTLIST(0, 250, 1, 100, 2, 100)) \
+                                                                                                                        \
+    /* Settings Settings */                                                                                             \
+    SETTING(Settings_HasForceUsedSetOnce, SETTING_SECTION_SETTINGS, "HasForceUsedSetOnce", false)                       \
+                                                                                                                        \
+    /* Audio Plugin Settings */                                                                                         \
+    SETTING(Audio_Volume, SETTING_SECTION_AUDIO, "Volume", 100)                                                         \
+    SETTING(Audio_Muted, SETTING_SECTION_AUDIO, "Muted", false)
+
 enum class SettingsID
 {
-    // GUI Settings
-    GUI_SettingsDialogWidth = 0,
-    GUI_SettingsDialogHeight,
-    GUI_AllowManualResizing,
-    GUI_HideCursorInEmulation,
-    GUI_StatusbarMessageDuration,
-
-    // Core Plugin Settings
-    Core_GFX_Plugin,
-    Core_AUDIO_Plugin,
-    Core_INPUT_Plugin,
-    Core_RSP_Plugin,
-
-    // Core User Directory Settings
-    Core_OverrideUserDirs,
-    Core_UserDataDirOverride,
-    Core_UserCacheDirOverride,
-
-    // Core 64DD ROM Settings
-    Core_64DD_RomFile,
-
-    // (mupen64plus) Core Settings
-    Core_OverrideGameSpecificSettings,
-    Core_RandomizeInterrupt,
-    Core_CPU_Emulator,
-    Core_DisableExtraMem,
-    Core_EnableDebugger,
-    Core_CountPerOp,
-    Core_SiDmaDuration,
-
-    // (mupen64plus) Core Directory Settings
-    Core_ScreenshotPath,
-    Core_SaveStatePath,
-    Core_SaveSRAMPath,
-    Core_SharedDataPath,
-
-    // Game Specific Settings
-    Game_DisableExtraMem,
-    Game_SaveType,
-    Game_CountPerOp,
-    Game_SiDmaDuration,
-
-    // Game Core Override Settings
-    Game_OverrideCoreSettings,
-    Game_CPU_Emulator,
-    Game_RandomizeInterrupt,
-
-    // Game Plugin Settings
-    Game_GFX_Plugin,
-    Game_AUDIO_Plugin,
-    Game_INPUT_Plugin,
-    Game_RSP_Plugin,
-
-    // GUI KeyBindings
-    KeyBinding_OpenROM,
-    KeyBinding_OpenCombo,
-    KeyBinding_StartEmulation,
-    KeyBinding_EndEmulation,
-    KeyBinding_RefreshROMList,
-    KeyBinding_Exit,
-    KeyBinding_SoftReset,
-    KeyBinding_HardReset,
-    KeyBinding_Resume,
-    KeyBinding_GenerateBitmap,
-    KeyBinding_LimitFPS,
-    KeyBinding_SwapDisk,
-    KeyBinding_SaveState,
-    KeyBinding_SaveAs,
-    KeyBinding_LoadState,
-    KeyBinding_Load,
-    KeyBinding_Cheats,
-    KeyBinding_GSButton,
-    KeyBinding_Fullscreen,
-    KeyBinding_Settings,
-
-    // RomBrowser Settings
-    RomBrowser_Directory,
-    RomBrowser_Geometry,
-    RomBrowser_Recursive,
-    RomBrowser_MaxItems,
-    RomBrowser_Columns,
-    RomBrowser_ColumnSizes,
-
-    // Settings Settings
-    Settings_HasForceUsedSetOnce,
-
-    // Audio Plugin Settings
-    Audio_Volume,
-    Audio_Muted,
-
+#define SETTING(id, ...) id,
+    SETTINGS_LIST(SETTING, SETTING)
+#undef SETTING
     Invalid
 };
 
@@ -7,11 +7,107 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
+#define CORE_INTERNAL
 #include "SpeedLimiter.hpp"
+#include "RunAhead.hpp"
+#include "Callback.hpp"
+#include "Plugins.hpp"
 #include "Error.hpp"
 
 #include "m64p/Api.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+//
+// Local Defines
+//
+
+// the range the core accepts
+#define SPEED_FACTOR_MIN 10
+#define SPEED_FACTOR_MAX 1000
+
+// how fast the speed factor moves towards
+// the requested one, in percent per second
+#define SPEED_FACTOR_RAMP_RATE 500
+
+//
+// Local Variables
+//
+
+static std::atomic<int> l_SpeedFactor = 100;
+
+// only used on the emulation thread
+static double                                l_CurrentSpeedFactor = 100;
+static int                                   l_AppliedSpeedFactor = 0;
+static std::chrono::steady_clock::time_point l_LastRampTime;
+
+//
+// Internal Functions
+//
+
+void CoreSpeedFactorStart(void)
+{
+    // the core keeps its speed factor between
+    // runs, so always apply it on the first frame
+    l_CurrentSpeedFactor = l_SpeedFactor;
+    l_AppliedSpeedFactor = 0;
+    l_LastRampTime = std::chrono::steady_clock::now();
+}
+
+void CoreSpeedFactorOnFrame(void)
+{
+    m64p_error ret;
+    int factor = l_SpeedFactor;
+    int coreFactor;
+
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - l_LastRampTime).count();
+    double step = SPEED_FACTOR_RAMP_RATE * seconds;
+    l_LastRampTime = now;
+
+    if (l_CurrentSpeedFactor < factor)
+    {
+        l_CurrentSpeedFactor = std::min<double>(l_CurrentSpeedFactor + step, factor);
+    }
+    else if (l_CurrentSpeedFactor > factor)
+    {
+        l_CurrentSpeedFactor = std::max<double>(l_CurrentSpeedFactor - step, factor);
+    }
+
+    factor = (int)std::lround(l_CurrentSpeedFactor);
+
+    // every real run-ahead frame is followed by the
+    // speculative frames, so the core has to run faster
+    // to keep the real frames at the requested speed
+    coreFactor = factor * (CoreGetRunAheadFrames() + 1);
+    coreFactor = std::clamp(coreFactor, SPEED_FACTOR_MIN, SPEED_FACTOR_MAX);
+    if (coreFactor == l_AppliedSpeedFactor)
+    {
+        return;
+    }
+
+    // don't retry every frame when it fails
+    l_AppliedSpeedFactor = coreFactor;
+
+    ret = m64p::Core.DoCommand(M64CMD_CORE_STATE_SET, M64CORE_SPEED_FACTOR, &coreFactor);
+    if (ret != M64ERR_SUCCESS)
+    {
+        CoreSetError("CoreSpeedFactorOnFrame: m64p::Core.DoCommand(M64CMD_CORE_STATE_SET) Failed: ", m64p::Core.ErrorMessage(ret));
+        return;
+    }
+
+    // the core passes its own speed factor to the
+    // audio plugin, which includes the speculative
+    // frames, so pass the real speed factor afterwards
+    if (coreFactor != factor)
+    {
+        CorePluginsSetAudioSpeedFactor(factor);
+    }
+}
+
 //
 // Exported Functions
 //
@@ -22,6 +118,11 @@ bool CoreIsSpeedLimiterEnabled(void)
     m64p_error ret;
     int value = 0;
 
+    if (CoreGetCachedState(CoreStateCallbackType::SpeedLimiter, value))
+    {
+        return value;
+    }
+
     ret = m64p::Core.DoCommand(M64CMD_CORE_STATE_QUERY, M64CORE_SPEED_LIMITER, &value);
     if (ret != M64ERR_SUCCESS)
     {
@@ -49,3 +150,27 @@ bool CoreSetSpeedLimiterState(bool enabled)
 
     return ret == M64ERR_SUCCESS;
 }
+
+int CoreGetSpeedFactor(void)
+{
+    return l_SpeedFactor;
+}
+
+bool CoreSetSpeedFactor(int factor)
+{
+    std::string error;
+
+    if (factor < SPEED_FACTOR_MIN || factor > SPEED_FACTOR_MAX)
+    {
+        error = "CoreSetSpeedFactor Failed: speed factor must be between ";
+        error += std::to_string(SPEED_FACTOR_MIN);
+        error += " and ";
+        error += std::to_string(SPEED_FACTOR_MAX);
+        error += "!";
+        CoreSetError(error);
+        return false;
+    }
+
+    l_SpeedFactor = factor;
+    return true;
+}
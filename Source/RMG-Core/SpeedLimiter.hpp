@@ -10,10 +10,31 @@
 #ifndef CORE_SPEEDLIMITER_HPP
 #define CORE_SPEEDLIMITER_HPP
 
+// internal speed factor functions
+#ifdef CORE_INTERNAL
+
+// resets the applied speed factor,
+// called before emulation starts
+void CoreSpeedFactorStart(void);
+
+// ramps the speed factor towards the requested
+// speed factor and applies it, called from
+// the frame callback
+void CoreSpeedFactorOnFrame(void);
+
+#endif // CORE_INTERNAL
+
 // returns whether the speed limiter is enabled
 bool CoreIsSpeedLimiterEnabled(void);
 
 // sets the speed limiter state
 bool CoreSetSpeedLimiterState(bool enabled);
 
+// returns the requested speed factor in percent
+int CoreGetSpeedFactor(void);
+
+// sets the speed factor in percent, the emulation
+// speed ramps towards it over a few frames
+bool CoreSetSpeedFactor(int factor);
+
 #endif // CORE_SPEEDLIMITER_HPP
@@ -0,0 +1,51 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "Trace.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+
+//
+// Local Variables
+//
+
+static std::chrono::steady_clock::time_point l_TraceStart;
+static bool                                  l_TraceEnabled = false;
+static std::once_flag                        l_TraceOnce;
+
+//
+// Exported Functions
+//
+
+void CoreTrace(std::string name)
+{
+    // the first trace point is the start
+    // of the trace, the environment variable
+    // is only checked once
+    std::call_once(l_TraceOnce, []
+    {
+        l_TraceStart = std::chrono::steady_clock::now();
+        l_TraceEnabled = std::getenv("RMG_TRACE") != nullptr;
+    });
+
+    if (!l_TraceEnabled)
+    {
+        return;
+    }
+
+    int64_t time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - l_TraceStart).count();
+
+    // stderr, so it isn't mixed with
+    // output which is parsed by scripts
+    fprintf(stderr, "[RMG-Core] trace: %8.2f ms: %s\n", time / 1000.0, name.c_str());
+}
@@ -0,0 +1,20 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_TRACE_HPP
+#define CORE_TRACE_HPP
+
+#include <string>
+
+// prints a trace point with the time since the
+// first trace point to stderr when the RMG_TRACE
+// environment variable is set, else it does nothing
+void CoreTrace(std::string name);
+
+#endif // CORE_TRACE_HPP
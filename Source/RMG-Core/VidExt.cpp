@@ -7,11 +7,48 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
+#define CORE_INTERNAL
 #include "VidExt.hpp"
+#include "RunAhead.hpp"
+#include "FrameStep.hpp"
 #include "Error.hpp"
 
 #include "m64p/Api.hpp"
 
+//
+// Local Variables
+//
+
+static m64p_error (*l_GLSwapBuffers)(void) = nullptr;
+static bool l_VidExtSetup = false;
+
+//
+// Local Functions
+//
+
+// skips presenting frames
+// which shouldn't be shown
+static m64p_error vidext_gl_swap_buffers(void)
+{
+    if (CoreRunAheadIsFrameHidden() ||
+        CoreFrameStepIsVideoDisabled() ||
+        l_GLSwapBuffers == nullptr)
+    {
+        return M64ERR_SUCCESS;
+    }
+
+    return l_GLSwapBuffers();
+}
+
+//
+// Internal Functions
+//
+
+bool CoreIsVidExtSetup(void)
+{
+    return l_VidExtSetup;
+}
+
 //
 // Exported Functions
 //
@@ -21,6 +58,9 @@ bool CoreSetupVidExt(m64p_video_extension_functions functions)
     std::string error;
     m64p_error ret;
 
+    l_GLSwapBuffers = functions.VidExtFuncGLSwapBuf;
+    functions.VidExtFuncGLSwapBuf = vidext_gl_swap_buffers;
+
     ret = m64p::Core.OverrideVidExt(&functions);
     if (ret != M64ERR_SUCCESS)
     {
@@ -29,5 +69,6 @@ bool CoreSetupVidExt(m64p_video_extension_functions functions)
         CoreSetError(error);
     }
 
+    l_VidExtSetup = ret == M64ERR_SUCCESS;
     return ret == M64ERR_SUCCESS;
 }
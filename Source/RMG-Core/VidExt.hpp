@@ -12,6 +12,22 @@
 
 #include "m64p/api/m64p_frontend.h"
 
+enum class VidExtRenderMode
+{
+    OpenGL = 0,
+    Vulkan = 1
+};
+
+// internal video extension functions
+#ifdef CORE_INTERNAL
+
+// returns whether CoreSetupVidExt() has been called,
+// without it the core's own video extension is used
+// and frames can't be skipped
+bool CoreIsVidExtSetup(void);
+
+#endif // CORE_INTERNAL
+
 bool CoreSetupVidExt(m64p_video_extension_functions functions);
 
 #endif // CORE_VIDEXT_HPP
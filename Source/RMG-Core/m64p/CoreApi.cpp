@@ -35,6 +35,10 @@ bool CoreApi::Hook(m64p_dynlib_handle handle)
     HOOK_FUNC(handle, Core, GetRomSettings);
     HOOK_FUNC(handle, Core, GetAPIVersions);
     HOOK_FUNC(handle, Core, ErrorMessage);
+#ifdef CORE_STATE_BUFFERS
+    HOOK_FUNC_OPT(handle, Core, SaveStateToMemory);
+    HOOK_FUNC_OPT(handle, Core, LoadStateFromMemory);
+#endif // CORE_STATE_BUFFERS
 
     this->handle = handle;
     this->hooked = true;
@@ -12,6 +12,7 @@
 
 #include "api/m64p_common.h"
 #include "api/m64p_frontend.h"
+#include "api/m64p_custom.h"
 
 #include <string>
 
@@ -40,6 +41,8 @@ class CoreApi
     ptr_CoreGetRomSettings GetRomSettings;
     ptr_CoreGetAPIVersions GetAPIVersions;
     ptr_CoreErrorMessage ErrorMessage;
+    ptr_CoreSaveStateToMemory SaveStateToMemory;
+    ptr_CoreLoadStateFromMemory LoadStateFromMemory;
 
   private:
     bool hooked = false;
@@ -27,6 +27,9 @@ bool PluginApi::Hook(m64p_dynlib_handle handle)
     HOOK_FUNC(handle, Plugin, Startup);
     HOOK_FUNC(handle, Plugin, Shutdown);
     HOOK_FUNC_OPT(handle, Plugin, Config);
+    HOOK_FUNC_OPT(handle, Plugin, AudioCapture);
+    HOOK_FUNC_OPT(handle, Plugin, AudioDiscard);
+    HOOK_FUNC_OPT(handle, , SetSpeedFactor);
     HOOK_FUNC(handle, Plugin, GetVersion);
 
     this->handle = handle;
@@ -39,6 +42,9 @@ bool PluginApi::Unhook(void)
     this->Startup = nullptr;
     this->Shutdown = nullptr;
     this->Config = nullptr;
+    this->AudioCapture = nullptr;
+    this->AudioDiscard = nullptr;
+    this->SetSpeedFactor = nullptr;
     this->GetVersion = nullptr;
     this->handle = nullptr;
     this->hooked = false;
@@ -12,6 +12,7 @@
 
 #include "api/m64p_common.h"
 #include "api/m64p_custom.h"
+#include "api/m64p_plugin.h"
 
 #include <string>
 
@@ -34,6 +35,9 @@ class PluginApi
     ptr_PluginStartup Startup;
     ptr_PluginShutdown Shutdown;
     ptr_PluginConfig Config;
+    ptr_PluginAudioCapture AudioCapture;
+    ptr_PluginAudioDiscard AudioDiscard;
+    ptr_SetSpeedFactor SetSpeedFactor;
     ptr_PluginGetVersion GetVersion;
 
   private:
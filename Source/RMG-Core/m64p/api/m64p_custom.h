@@ -9,6 +9,8 @@ extern "C" {
 
 #include "m64p_types.h"
 
+#include <stddef.h>
+
 
 /* PluginConfig()
  *
@@ -21,6 +23,60 @@ typedef m64p_error (*ptr_PluginConfig)(void);
 EXPORT m64p_error CALL PluginConfig(void);
 #endif
 
+/* PluginAudioCapture()
+ *
+ * This optional function sets a callback which receives every buffer
+ * of 16-bit stereo PCM samples the game sends to the audio plugin,
+ * passing NULL stops the capture
+ *
+*/
+typedef void (*ptr_AudioCaptureCallback)(const void *, int, int);
+typedef m64p_error (*ptr_PluginAudioCapture)(ptr_AudioCaptureCallback);
+#if defined(M64P_PLUGIN_PROTOTYPES) || defined(M64P_CORE_PROTOTYPES)
+EXPORT m64p_error CALL PluginAudioCapture(ptr_AudioCaptureCallback);
+#endif
+
+/* PluginAudioDiscard()
+ *
+ * This optional function sets whether the audio plugin discards
+ * the samples it receives instead of playing them,
+ * i.e for frames which are emulated speculatively
+ *
+*/
+typedef m64p_error (*ptr_PluginAudioDiscard)(int);
+#if defined(M64P_PLUGIN_PROTOTYPES) || defined(M64P_CORE_PROTOTYPES)
+EXPORT m64p_error CALL PluginAudioDiscard(int);
+#endif
+
+/* CoreSaveStateToMemory()
+ *
+ * This optional function serializes the current emulator state into
+ * the given buffer without compressing it or writing it to a file,
+ * the buffer contains the uncompressed mupen64plus save state, so
+ * compressing it with gzip results in a regular save state file,
+ * size contains the size of the buffer and is set to the size of the
+ * state, when the buffer is NULL or too small M64ERR_INPUT_INVALID is
+ * returned with size set to the required size,
+ * emulation must be paused or it must be called from the frame callback
+ *
+*/
+typedef m64p_error (*ptr_CoreSaveStateToMemory)(void *, size_t *);
+#if defined(M64P_CORE_PROTOTYPES)
+EXPORT m64p_error CALL CoreSaveStateToMemory(void *, size_t *);
+#endif
+
+/* CoreLoadStateFromMemory()
+ *
+ * This optional function restores the emulator state from a buffer
+ * filled by CoreSaveStateToMemory(),
+ * emulation must be paused or it must be called from the frame callback
+ *
+*/
+typedef m64p_error (*ptr_CoreLoadStateFromMemory)(const void *, size_t);
+#if defined(M64P_CORE_PROTOTYPES)
+EXPORT m64p_error CALL CoreLoadStateFromMemory(const void *, size_t);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -35,9 +35,10 @@ bool CoreCallbacks::Init(void)
 {
     // needed for Qt
     qRegisterMetaType<CoreDebugMessageType>("CoreDebugMessageType");
+    qRegisterMetaType<CoreStateCallbackType>("CoreStateCallbackType");
 
     l_CoreCallbacks = this;
-    return CoreSetupCallbacks(this->coreDebugCallback);
+    return CoreSetupCallbacks(this->coreDebugCallback, this->coreStateCallback);
 }
 
 void CoreCallbacks::Stop(void)
@@ -54,3 +55,13 @@ void CoreCallbacks::coreDebugCallback(CoreDebugMessageType type, std::string mes
 
     emit l_CoreCallbacks->OnCoreDebugCallback(type, QString::fromStdString(message));
 }
+
+void CoreCallbacks::coreStateCallback(CoreStateCallbackType type, int value)
+{
+    if (l_CoreCallbacks == nullptr)
+    {
+        return;
+    }
+
+    emit l_CoreCallbacks->OnCoreStateCallback(type, value);
+}
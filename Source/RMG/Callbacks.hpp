@@ -27,9 +27,11 @@ public:
 
 private:
     static void coreDebugCallback(CoreDebugMessageType type, std::string message);
+    static void coreStateCallback(CoreStateCallbackType type, int value);
 
 signals:
     void OnCoreDebugCallback(CoreDebugMessageType type, QString message);
+    void OnCoreStateCallback(CoreStateCallbackType type, int value);
 };
 
 #endif // RMG_CALLBACKS_HPP
@@ -14,6 +14,7 @@ using namespace Thread;
 
 EmulationThread::EmulationThread(QObject *parent) : QThread(parent)
 {
+    qRegisterMetaType<VidExtRenderMode>("VidExtRenderMode");
 }
 
 EmulationThread::~EmulationThread(void)
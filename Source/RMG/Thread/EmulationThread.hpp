@@ -10,10 +10,14 @@
 #ifndef EMULATIONTHREAD_HPP
 #define EMULATIONTHREAD_HPP
 
+#include <QList>
+#include <QSize>
 #include <QString>
 #include <QSurfaceFormat>
 #include <QThread>
 
+#include <RMG-Core/VidExt.hpp>
+
 namespace Thread
 {
 class EmulationThread : public QThread
@@ -41,14 +45,16 @@ class EmulationThread : public QThread
     void on_Emulation_Finished(bool);
 
     void on_VidExt_SetupOGL(QSurfaceFormat, QThread *);
+    void on_VidExt_SetupVK(void);
     void on_VidExt_ResizeWindow(int, int);
 
-    void on_VidExt_Init(void);
+    void on_VidExt_Init(VidExtRenderMode);
     void on_VidExt_SetMode(int, int, int, int, int);
     void on_VidExt_SetWindowedModeWithRate(int, int, int, int, int);
     void on_VidExt_SetFullscreenModeWithRate(int, int, int, int, int);
     void on_VidExt_SetCaption(QString);
     void on_VidExt_ToggleFS(bool);
+    void on_VidExt_ListScreenModes(QList<QSize> *, QList<int> *);
     void on_VidExt_Quit(void);
 
     void createOGLWindow(QSurfaceFormat *format, QThread *thread);
@@ -0,0 +1,43 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "PluginLoaderThread.hpp"
+#include <RMG-Core/Core.hpp>
+
+using namespace Thread;
+
+PluginLoaderThread::PluginLoaderThread(QObject *parent) : QThread(parent)
+{
+}
+
+PluginLoaderThread::~PluginLoaderThread(void)
+{
+    this->wait();
+}
+
+void PluginLoaderThread::run(void)
+{
+    bool ret;
+
+    ret = CoreApplyPluginSettings();
+
+    if (!ret)
+    {
+        this->error_Message = QString::fromStdString(CoreGetError());
+    }
+
+    CoreTrace("PluginLoaderThread: loaded plugins");
+
+    emit this->on_Plugins_Loaded(ret);
+}
+
+QString PluginLoaderThread::GetLastError(void)
+{
+    return this->error_Message;
+}
@@ -0,0 +1,38 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef PLUGINLOADERTHREAD_HPP
+#define PLUGINLOADERTHREAD_HPP
+
+#include <QString>
+#include <QThread>
+
+namespace Thread
+{
+class PluginLoaderThread : public QThread
+{
+    Q_OBJECT
+
+  public:
+    PluginLoaderThread(QObject *);
+    ~PluginLoaderThread(void);
+
+    void run(void) override;
+
+    QString GetLastError(void);
+
+  private:
+    QString error_Message;
+
+  signals:
+    void on_Plugins_Loaded(bool);
+};
+} // namespace Thread
+
+#endif // PLUGINLOADERTHREAD_HPP
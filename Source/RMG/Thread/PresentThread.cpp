@@ -0,0 +1,176 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "PresentThread.hpp"
+
+using namespace Thread;
+
+PresentThread::PresentThread(QObject *parent) : QThread(parent)
+{
+}
+
+PresentThread::~PresentThread(void)
+{
+}
+
+void PresentThread::SetSurface(QOpenGLContext *context, QWindow *surface)
+{
+    this->context = context;
+    this->surface = surface;
+    this->stop = false;
+}
+
+int PresentThread::AcquireSlot(GLsync *readFence)
+{
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    for (int i = 0; i < PRESENT_SLOTS; i++)
+    {
+        if (i != this->pendingSlot &&
+            i != this->presentingSlot)
+        {
+            *readFence = this->presentSlots[i].readFence;
+            this->presentSlots[i].readFence = 0;
+            return i;
+        }
+    }
+
+    // should never happen
+    *readFence = 0;
+    return 0;
+}
+
+void PresentThread::Present(int slot, GLuint texture, int width, int height, GLsync fence)
+{
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    // mailbox semantics, drop the
+    // frame which wasn't presented yet
+    if (this->pendingSlot != -1)
+    {
+        Slot *droppedSlot = &this->presentSlots[this->pendingSlot];
+        if (droppedSlot->renderFence != 0)
+        {
+            QOpenGLContext::currentContext()->extraFunctions()->glDeleteSync(droppedSlot->renderFence);
+            droppedSlot->renderFence = 0;
+        }
+    }
+
+    Slot *presentSlot = &this->presentSlots[slot];
+    presentSlot->texture = texture;
+    presentSlot->width = width;
+    presentSlot->height = height;
+    presentSlot->renderFence = fence;
+
+    this->pendingSlot = slot;
+    this->condition.notify_one();
+}
+
+void PresentThread::Stop(QThread *thread)
+{
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->returnThread = thread;
+        this->stop = true;
+        this->condition.notify_one();
+    }
+
+    this->wait();
+}
+
+void PresentThread::run(void)
+{
+    QOpenGLExtraFunctions *functions;
+    Slot *slot;
+
+    this->context->makeCurrent(this->surface);
+    functions = this->context->extraFunctions();
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->condition.wait(lock, [this] { return this->stop || this->pendingSlot != -1; });
+
+            if (this->stop)
+            {
+                break;
+            }
+
+            this->presentingSlot = this->pendingSlot;
+            this->pendingSlot = -1;
+            slot = &this->presentSlots[this->presentingSlot];
+        }
+
+        this->present_Slot(functions, slot);
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->presentingSlot = -1;
+        }
+    }
+
+    // clean up the framebuffers & fences
+    for (Slot &presentSlot : this->presentSlots)
+    {
+        if (presentSlot.framebuffer != 0)
+        {
+            functions->glDeleteFramebuffers(1, &presentSlot.framebuffer);
+        }
+        if (presentSlot.renderFence != 0)
+        {
+            functions->glDeleteSync(presentSlot.renderFence);
+        }
+        if (presentSlot.readFence != 0)
+        {
+            functions->glDeleteSync(presentSlot.readFence);
+        }
+
+        presentSlot = Slot();
+    }
+
+    this->pendingSlot = -1;
+    this->presentingSlot = -1;
+
+    this->context->doneCurrent();
+    this->context->moveToThread(this->returnThread);
+}
+
+void PresentThread::present_Slot(QOpenGLExtraFunctions *functions, Slot *slot)
+{
+    int surfaceWidth = this->surface->width() * this->surface->devicePixelRatio();
+    int surfaceHeight = this->surface->height() * this->surface->devicePixelRatio();
+
+    // wait on the GPU until the
+    // frame has been rendered
+    functions->glWaitSync(slot->renderFence, 0, GL_TIMEOUT_IGNORED);
+    functions->glDeleteSync(slot->renderFence);
+    slot->renderFence = 0;
+
+    // framebuffer objects aren't shared between
+    // contexts, so attach the texture to our own
+    if (slot->framebuffer == 0)
+    {
+        functions->glGenFramebuffers(1, &slot->framebuffer);
+    }
+    functions->glBindFramebuffer(GL_READ_FRAMEBUFFER, slot->framebuffer);
+    functions->glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, slot->texture, 0);
+    functions->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, this->context->defaultFramebufferObject());
+
+    functions->glBlitFramebuffer(0, 0, slot->width, slot->height,
+                                 0, 0, surfaceWidth, surfaceHeight,
+                                 GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+    // the texture can be re-used
+    // once the blit has completed
+    slot->readFence = functions->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    functions->glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    this->context->swapBuffers(this->surface);
+}
@@ -0,0 +1,88 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef PRESENTTHREAD_HPP
+#define PRESENTTHREAD_HPP
+
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QThread>
+#include <QWindow>
+
+#include <condition_variable>
+#include <mutex>
+
+// amount of textures used to hand frames
+// over to the present thread, one is being
+// presented, one is the latest frame and
+// one is being rendered to
+#define PRESENT_SLOTS 3
+
+namespace Thread
+{
+// presents frames rendered on another (shared) context
+// using mailbox semantics, only the latest frame is
+// presented and older frames which haven't been
+// presented yet are dropped, so a slow swap never
+// stalls the thread rendering the frames
+class PresentThread : public QThread
+{
+  public:
+    PresentThread(QObject *);
+    ~PresentThread(void);
+
+    // sets the context & surface used for presenting,
+    // the context has to be moved to this thread
+    void SetSurface(QOpenGLContext *, QWindow *);
+
+    // returns a slot which isn't in use by the present thread,
+    // the caller must wait for the returned fence (when not 0)
+    // before writing to the texture of the slot
+    int AcquireSlot(GLsync *readFence);
+
+    // queues the texture of the given slot for presenting,
+    // the present thread waits for the given fence
+    // before reading from the texture
+    void Present(int slot, GLuint texture, int width, int height, GLsync fence);
+
+    // stops the thread, the context is moved
+    // back to the given thread
+    void Stop(QThread *);
+
+    void run(void) override;
+
+  private:
+    struct Slot
+    {
+        GLuint texture = 0;
+        GLuint framebuffer = 0;
+        int width = 0;
+        int height = 0;
+        GLsync renderFence = 0;
+        GLsync readFence = 0;
+    };
+
+    QOpenGLContext *context = nullptr;
+    QWindow *surface = nullptr;
+    QThread *returnThread = nullptr;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    Slot presentSlots[PRESENT_SLOTS];
+    int pendingSlot = -1;
+    int presentingSlot = -1;
+    int lastSlot = -1;
+    bool stop = false;
+
+    void present_Slot(QOpenGLExtraFunctions *, Slot *);
+};
+} // namespace Thread
+
+#endif // PRESENTTHREAD_HPP
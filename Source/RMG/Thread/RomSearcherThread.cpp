@@ -46,9 +46,15 @@ void RomSearcherThread::SetMaximumFiles(int value)
     this->rom_Search_MaxItems = value;
 }
 
+void RomSearcherThread::SetRomDatabaseFile(QString file)
+{
+    this->rom_Database_File = file.toStdString();
+}
+
 void RomSearcherThread::run(void)
 {
     this->rom_Search(this->rom_Directory);
+    CoreSaveRomHeaderAndSettingsCache();
     return;
 }
 
@@ -77,15 +83,21 @@ void RomSearcherThread::rom_Search(QString directory)
     while (romDirIt.hasNext())
     {
         QString file = romDirIt.next();
+        std::string fileStr = file.toStdString();
+
+        // reading the ROM is slow, so try the cache first
+        ret = CoreGetCachedRomHeaderAndSettings(fileStr, header, settings);
+        if (!ret)
+        {
+            // inspect the ROM without using the core,
+            // so scanning can't interfere with emulation
+            ret = CoreInspectRom(fileStr, this->rom_Database_File, header, settings);
+            if (ret)
+            {
+                CoreAddCachedRomHeaderAndSettings(fileStr, header, settings);
+            }
+        }
 
-        // open rom, retrieve rom settings & header 
-        ret = CoreOpenRom(file.toStdString()) && 
-            CoreGetCurrentRomSettings(settings) && 
-            CoreGetCurrentRomHeader(header);
-        // always close the ROM,
-        // even when retrieving rom info failed
-        ret = CoreCloseRom() && ret;
-        
         if (ret)
         {
             if (count++ >= this->rom_Search_MaxItems)
@@ -10,6 +10,8 @@
 #include "SettingsDialog.hpp"
 
 #include <QFileDialog>
+#include <QGuiApplication>
+#include <QScreen>
 
 using namespace UserInterface::Dialog;
 
@@ -50,9 +52,10 @@ SettingsDialog::SettingsDialog(QWidget *parent) : QDialog(parent, Qt::WindowSyst
 
 SettingsDialog::~SettingsDialog(void)
 {
+    CoreSettingsBeginBatch();
     CoreSettingsSetValue(SettingsID::GUI_SettingsDialogWidth, this->size().width());
     CoreSettingsSetValue(SettingsID::GUI_SettingsDialogHeight, this->size().height());
-    CoreSettingsSave();
+    CoreSettingsCommitBatch();
 }
 
 int SettingsDialog::currentIndex(void)
@@ -316,8 +319,10 @@ void SettingsDialog::loadHotkeySettings(void)
 void SettingsDialog::loadInterfaceSettings(void)
 {
     this->manualResizingCheckBox->setChecked(CoreSettingsGetBoolValue(SettingsID::GUI_AllowManualResizing));
+    this->threadedPresentCheckBox->setChecked(CoreSettingsGetBoolValue(SettingsID::GUI_ThreadedPresent));
     this->hideCursorCheckBox->setChecked(CoreSettingsGetBoolValue(SettingsID::GUI_HideCursorInEmulation));
     this->statusBarMessageDurationSpinBox->setValue(CoreSettingsGetIntValue(SettingsID::GUI_StatusbarMessageDuration));
+    this->commonFullscreenScreenSettings(CoreSettingsGetStringValue(SettingsID::GUI_FullscreenScreen));
     this->searchSubDirectoriesCheckbox->setChecked(CoreSettingsGetBoolValue(SettingsID::RomBrowser_Recursive));
     this->romSearchLimitSpinBox->setValue(CoreSettingsGetIntValue(SettingsID::RomBrowser_MaxItems));
 }
@@ -411,14 +416,17 @@ void SettingsDialog::loadDefaultHotkeySettings(void)
 void SettingsDialog::loadDefaultInterfaceSettings(void)
 {
     this->manualResizingCheckBox->setChecked(CoreSettingsGetDefaultBoolValue(SettingsID::GUI_AllowManualResizing));
+    this->threadedPresentCheckBox->setChecked(CoreSettingsGetDefaultBoolValue(SettingsID::GUI_ThreadedPresent));
     this->hideCursorCheckBox->setChecked(CoreSettingsGetDefaultBoolValue(SettingsID::GUI_HideCursorInEmulation));
     this->statusBarMessageDurationSpinBox->setValue(CoreSettingsGetDefaultIntValue(SettingsID::GUI_StatusbarMessageDuration));
+    this->commonFullscreenScreenSettings(CoreSettingsGetDefaultStringValue(SettingsID::GUI_FullscreenScreen));
     this->searchSubDirectoriesCheckbox->setChecked(CoreSettingsGetDefaultBoolValue(SettingsID::RomBrowser_Recursive));
     this->romSearchLimitSpinBox->setValue(CoreSettingsGetDefaultIntValue(SettingsID::RomBrowser_MaxItems));
 }
 
 void SettingsDialog::saveSettings(void)
 {
+    CoreSettingsBeginBatch();
     this->saveCoreSettings();
     if (inGame)
     {
@@ -432,6 +440,7 @@ void SettingsDialog::saveSettings(void)
     this->saveDirectorySettings();
     this->saveHotkeySettings();
     this->saveInterfaceSettings();
+    CoreSettingsCommitBatch();
 }
 
 void SettingsDialog::saveCoreSettings(void)
@@ -568,8 +577,10 @@ void SettingsDialog::saveHotkeySettings(void)
 void SettingsDialog::saveInterfaceSettings(void)
 {
     CoreSettingsSetValue(SettingsID::GUI_AllowManualResizing, this->manualResizingCheckBox->isChecked());
+    CoreSettingsSetValue(SettingsID::GUI_ThreadedPresent, this->threadedPresentCheckBox->isChecked());
     CoreSettingsSetValue(SettingsID::GUI_HideCursorInEmulation, this->hideCursorCheckBox->isChecked());
     CoreSettingsSetValue(SettingsID::GUI_StatusbarMessageDuration, this->statusBarMessageDurationSpinBox->value());
+    CoreSettingsSetValue(SettingsID::GUI_FullscreenScreen, this->fullscreenScreenComboBox->currentData().toString().toStdString());
     CoreSettingsSetValue(SettingsID::RomBrowser_Recursive, this->searchSubDirectoriesCheckbox->isChecked());
     CoreSettingsSetValue(SettingsID::RomBrowser_MaxItems, this->romSearchLimitSpinBox->value());
 }
@@ -592,6 +603,7 @@ void SettingsDialog::commonHotkeySettings(int action)
         { this->hardResetKeyButton, SettingsID::KeyBinding_HardReset },
         { this->pauseKeyButton, SettingsID::KeyBinding_Resume },
         { this->generateBitmapKeyButton, SettingsID::KeyBinding_GenerateBitmap },
+        { this->recordVideoKeyButton, SettingsID::KeyBinding_RecordVideo },
         { this->limitFPSKeyButton, SettingsID::KeyBinding_LimitFPS },
         { this->swapDiskKeyButton, SettingsID::KeyBinding_SwapDisk },
         { this->saveStateKeyButton, SettingsID::KeyBinding_SaveState },
@@ -602,8 +614,16 @@ void SettingsDialog::commonHotkeySettings(int action)
         { this->gsButtonKeyButton, SettingsID::KeyBinding_GSButton },
         { this->fullscreenKeyButton, SettingsID::KeyBinding_Fullscreen },
         { this->settingsKeyButton, SettingsID::KeyBinding_Settings },
+        { this->rewindKeyButton, SettingsID::KeyBinding_Rewind },
+        { this->fastForwardHoldKeyButton, SettingsID::KeyBinding_FastForwardHold },
+        { this->fastForwardToggleKeyButton, SettingsID::KeyBinding_FastForwardToggle },
+        { this->slowMotionToggleKeyButton, SettingsID::KeyBinding_SlowMotionToggle },
     };
 
+    // rewinding requires in-memory save states
+    this->rewindKeyButton->setVisible(CoreSupportsSaveStateBuffers());
+    this->label_91->setVisible(CoreSupportsSaveStateBuffers());
+
     for (const auto& keybinding : keybindings)
     {
         switch (action)
@@ -622,6 +642,38 @@ void SettingsDialog::commonHotkeySettings(int action)
     }
 }
 
+void SettingsDialog::commonFullscreenScreenSettings(std::string screenName)
+{
+    this->fullscreenScreenComboBox->clear();
+    this->fullscreenScreenComboBox->addItem("**Use Current Screen**", "");
+
+    for (QScreen *screen : QGuiApplication::screens())
+    {
+        QSize size = screen->size() * screen->devicePixelRatio();
+        QString text = QString("%1 (%2x%3 @ %4 Hz)")
+                        .arg(screen->name())
+                        .arg(size.width())
+                        .arg(size.height())
+                        .arg(qRound(screen->refreshRate()));
+
+        this->fullscreenScreenComboBox->addItem(text, screen->name());
+
+        if (screen->name().toStdString() == screenName)
+        {
+            this->fullscreenScreenComboBox->setCurrentIndex(this->fullscreenScreenComboBox->count() - 1);
+        }
+    }
+
+    // keep the setting when the screen
+    // isn't connected at the moment
+    if (!screenName.empty() && this->fullscreenScreenComboBox->currentIndex() == 0)
+    {
+        QString name = QString::fromStdString(screenName);
+        this->fullscreenScreenComboBox->addItem(name + " (Disconnected)", name);
+        this->fullscreenScreenComboBox->setCurrentIndex(this->fullscreenScreenComboBox->count() - 1);
+    }
+}
+
 void SettingsDialog::hideEmulationInfoText(void)
 {
     QHBoxLayout *layouts[] = {this->emulationInfoLayout_0, this->emulationInfoLayout_1, this->emulationInfoLayout_2};
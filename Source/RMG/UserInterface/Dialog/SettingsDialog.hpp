@@ -76,6 +76,7 @@ class SettingsDialog : public QDialog, private Ui::SettingsDialog
     void saveInterfaceSettings(void);
 
     void commonHotkeySettings(int);
+    void commonFullscreenScreenSettings(std::string);
 
     void hideEmulationInfoText(void);
 
@@ -18,15 +18,19 @@
 #include <RMG-Core/Core.hpp>
 
 #include <QCoreApplication>
+#include <QDateTime>
 #include <QDesktopServices>
+#include <QDir>
 #include <QFileDialog>
 #include <QMenuBar>
 #include <QMessageBox>
 #include <QMimeData>
+#include <QRegularExpression>
 #include <QSettings>
 #include <QStatusBar>
 #include <QString>
 #include <QUrl>
+#include <QWindow>
 #include <QActionGroup> 
 
 using namespace UserInterface;
@@ -47,6 +51,8 @@ bool MainWindow::Init(void)
         return false;
     }
 
+    CoreTrace("MainWindow::Init: core initialized");
+
     this->ui_Init();
     this->ui_Setup();
 
@@ -56,10 +62,12 @@ bool MainWindow::Init(void)
     this->menuBar_Init();
     this->menuBar_Setup(false, false);
 
+    CoreTrace("MainWindow::Init: ui initialized");
+
     this->emulationThread_Init();
     this->emulationThread_Connect();
 
-    if (!SetupVidExt(this->emulationThread, this, this->ui_Widget_OpenGL))
+    if (!SetupVidExt(this->emulationThread, this, this->ui_Widget_OpenGL, this->ui_Widget_Vulkan))
     {
         this->ui_MessageBox("Error", "SetupVidExt() Failed", QString::fromStdString(CoreGetError()));
         return false;
@@ -73,7 +81,13 @@ bool MainWindow::Init(void)
     }
 
     connect(coreCallBacks, &CoreCallbacks::OnCoreDebugCallback, this, &MainWindow::on_Core_DebugCallback);
+    connect(coreCallBacks, &CoreCallbacks::OnCoreStateCallback, this, &MainWindow::on_Core_StateCallback);
+
+    // loading the plugins is slow, so do it
+    // in the background while the window is shown
+    this->pluginLoaderThread_Init();
 
+    CoreTrace("MainWindow::Init: finished");
     return true;
 }
 
@@ -93,10 +107,14 @@ void MainWindow::closeEvent(QCloseEvent *event)
         QCoreApplication::processEvents();
     }
 
-    std::string geometryStr = this->saveGeometry().toBase64().toStdString();
+    // the loader thread is deleted with the window
+    this->pluginLoaderThread_Wait();
 
-    CoreSettingsSetValue(SettingsID::RomBrowser_Geometry, geometryStr);
-    CoreSettingsSave();
+    QByteArray geometry = this->saveGeometry();
+
+    CoreSettingsBeginBatch();
+    CoreSettingsSetValue(SettingsID::RomBrowser_Geometry, std::vector<char>(geometry.begin(), geometry.end()));
+    CoreSettingsCommitBatch();
 
     CoreShutdown();
 
@@ -110,6 +128,7 @@ void MainWindow::ui_Init(void)
     this->ui_Widgets = new QStackedWidget(this);
     this->ui_Widget_RomBrowser = new Widget::RomBrowserWidget(this);
     this->ui_Widget_OpenGL = new Widget::OGLWidget(this);
+    this->ui_Widget_Vulkan = new Widget::VKWidget(this);
     this->ui_EventFilter = new EventFilter(this);
     this->ui_StatusBar_Label = new QLabel(this);
 
@@ -144,12 +163,12 @@ void MainWindow::ui_Setup(void)
     this->setWindowTitle(WINDOW_TITLE);
     this->setCentralWidget(this->ui_Widgets);
 
-    QString geometry;
-    geometry = QString::fromStdString(CoreSettingsGetStringValue(SettingsID::RomBrowser_Geometry));
+    std::vector<char> geometry;
+    geometry = CoreSettingsGetBlobValue(SettingsID::RomBrowser_Geometry);
 
-    if (!geometry.isEmpty())
+    if (!geometry.empty())
     {
-        this->restoreGeometry(QByteArray::fromBase64(geometry.toLocal8Bit()));
+        this->restoreGeometry(QByteArray(geometry.data(), geometry.size()));
     }
     else
     {
@@ -162,12 +181,14 @@ void MainWindow::ui_Setup(void)
 
     this->ui_Widgets->addWidget(this->ui_Widget_RomBrowser);
     this->ui_Widgets->addWidget(this->ui_Widget_OpenGL->GetWidget());
+    this->ui_Widgets->addWidget(this->ui_Widget_Vulkan->GetWidget());
 
     this->ui_Widgets->setCurrentIndex(0);
 
     this->setFocusPolicy(Qt::FocusPolicy::StrongFocus);
     this->installEventFilter(this->ui_EventFilter);
     this->ui_Widget_OpenGL->installEventFilter(this->ui_EventFilter);
+    this->ui_Widget_Vulkan->installEventFilter(this->ui_EventFilter);
 }
 
 void MainWindow::ui_Stylesheet_Setup(void)
@@ -193,6 +214,33 @@ void MainWindow::ui_MessageBox(QString title, QString text, QString details = ""
     msgBox.exec();
 }
 
+bool MainWindow::ui_IsKeyBinding(QKeyEvent *event, SettingsID settingId)
+{
+    QKeySequence keyBinding(QString::fromStdString(CoreSettingsGetStringValue(settingId)));
+    QKeySequence keySequence(event->modifiers() | event->key());
+
+    return !keyBinding.isEmpty() && keyBinding == keySequence;
+}
+
+void MainWindow::ui_UpdateSpeedFactor(void)
+{
+    int factor = 100;
+
+    if (this->ui_FastForwardHeld || this->ui_FastForwardToggled)
+    {
+        factor = CoreSettingsGetIntValue(SettingsID::Core_FastForwardSpeed);
+    }
+    else if (this->ui_SlowMotionToggled)
+    {
+        factor = CoreSettingsGetIntValue(SettingsID::Core_SlowMotionSpeed);
+    }
+
+    if (!CoreSetSpeedFactor(factor))
+    {
+        this->ui_MessageBox("Error", "CoreSetSpeedFactor() Failed!", QString::fromStdString(CoreGetError()));
+    }
+}
+
 void MainWindow::ui_InEmulation(bool inEmulation, bool isPaused)
 {
     if (!this->ui_NoSwitchToRomBrowser)
@@ -210,7 +258,7 @@ void MainWindow::ui_InEmulation(bool inEmulation, bool isPaused)
             this->setWindowTitle(QString::fromStdString(settings.GoodName) + QString(" - ") + QString(WINDOW_TITLE));
         }
 
-        this->ui_Widgets->setCurrentIndex(1);
+        this->ui_Widgets->setCurrentIndex(this->ui_VidExtRenderMode == VidExtRenderMode::Vulkan ? 2 : 1);
         this->ui_SaveGeometry();
     }
     else if (!this->ui_NoSwitchToRomBrowser)
@@ -268,6 +316,22 @@ void MainWindow::ui_LoadGeometry(void)
     this->ui_Geometry_Saved = false;
 }
 
+void MainWindow::ui_MoveToFullscreenScreen(void)
+{
+    QScreen* screen = VidExtGetFullscreenScreen();
+    QWindow* window = this->windowHandle();
+    if (screen == nullptr || window == nullptr ||
+        window->screen() == screen)
+    {
+        return;
+    }
+
+    // move the window onto the chosen screen,
+    // so showFullScreen() uses that screen
+    window->setScreen(screen);
+    this->move(screen->geometry().topLeft());
+}
+
 void MainWindow::menuBar_Init(void)
 {
     this->menuBar = new QMenuBar(this);
@@ -319,6 +383,7 @@ void MainWindow::menuBar_Setup(bool inEmulation, bool isPaused)
         this->menuBar_Menu->addMenu(resetMenu);
         this->menuBar_Menu->addAction(this->action_System_Pause);
         this->menuBar_Menu->addAction(this->action_System_GenerateBitmap);
+        this->menuBar_Menu->addAction(this->action_System_RecordVideo);
         this->menuBar_Menu->addSeparator();
         this->menuBar_Menu->addAction(this->action_System_LimitFPS);
         this->menuBar_Menu->addSeparator();
@@ -398,6 +463,8 @@ void MainWindow::emulationThread_Connect(void)
             Qt::BlockingQueuedConnection);
     connect(this->emulationThread, &Thread::EmulationThread::on_VidExt_SetupOGL, this, &MainWindow::on_VidExt_SetupOGL,
             Qt::BlockingQueuedConnection);
+    connect(this->emulationThread, &Thread::EmulationThread::on_VidExt_SetupVK, this, &MainWindow::on_VidExt_SetupVK,
+            Qt::BlockingQueuedConnection);
     connect(this->emulationThread, &Thread::EmulationThread::on_VidExt_SetMode, this, &MainWindow::on_VidExt_SetMode,
             Qt::BlockingQueuedConnection);
     connect(this->emulationThread, &Thread::EmulationThread::on_VidExt_SetWindowedModeWithRate, this,
@@ -408,16 +475,38 @@ void MainWindow::emulationThread_Connect(void)
             &MainWindow::on_VidExt_ResizeWindow, Qt::BlockingQueuedConnection);
     connect(this->emulationThread, &Thread::EmulationThread::on_VidExt_SetCaption, this,
             &MainWindow::on_VidExt_SetCaption, Qt::BlockingQueuedConnection);
+    // toggling fullscreen doesn't need to block
+    // emulation until the window manager is done
     connect(this->emulationThread, &Thread::EmulationThread::on_VidExt_ToggleFS, this, &MainWindow::on_VidExt_ToggleFS,
-            Qt::BlockingQueuedConnection);
+            Qt::QueuedConnection);
+    connect(this->emulationThread, &Thread::EmulationThread::on_VidExt_ListScreenModes, this,
+            &MainWindow::on_VidExt_ListScreenModes, Qt::BlockingQueuedConnection);
     connect(this->emulationThread, &Thread::EmulationThread::on_VidExt_Quit, this, &MainWindow::on_VidExt_Quit,
             Qt::BlockingQueuedConnection);
 }
 
-void MainWindow::emulationThread_Launch(QString cartRom, QString diskRom)
+void MainWindow::pluginLoaderThread_Init(void)
 {
-    CoreSettingsSave();
+    this->pluginLoaderThread = new Thread::PluginLoaderThread(this);
+
+    connect(this->pluginLoaderThread, &Thread::PluginLoaderThread::on_Plugins_Loaded, this,
+            &MainWindow::on_PluginLoader_Finished);
+
+    this->pluginLoaderThread->start();
+}
 
+void MainWindow::pluginLoaderThread_Wait(void)
+{
+    // the plugins and the core's config are
+    // used by the loader until it has finished
+    while (this->pluginLoaderThread->isRunning())
+    {
+        QCoreApplication::processEvents();
+    }
+}
+
+void MainWindow::emulationThread_Launch(QString cartRom, QString diskRom)
+{
     if (this->emulationThread->isRunning())
     {
         this->on_Action_File_EndEmulation();
@@ -434,6 +523,9 @@ void MainWindow::emulationThread_Launch(QString cartRom, QString diskRom)
         this->ui_Widget_RomBrowser->StopRefreshRomList();
     }
 
+    // plugins may still be loading
+    this->pluginLoaderThread_Wait();
+
     if (!CoreArePluginsReady())
     {
         this->ui_MessageBox("Error", "CoreArePluginsReady() Failed", QString::fromStdString(CoreGetError()));
@@ -445,6 +537,14 @@ void MainWindow::emulationThread_Launch(QString cartRom, QString diskRom)
 
     this->ui_Widget_OpenGL->SetAllowResizing(this->ui_AllowManualResizing);
     this->ui_Widget_OpenGL->SetHideCursor(this->ui_HideCursorInEmulation);
+    this->ui_Widget_Vulkan->SetAllowResizing(this->ui_AllowManualResizing);
+    this->ui_Widget_Vulkan->SetHideCursor(this->ui_HideCursorInEmulation);
+
+    // always start at normal speed
+    this->ui_FastForwardHeld = false;
+    this->ui_FastForwardToggled = false;
+    this->ui_SlowMotionToggled = false;
+    this->ui_UpdateSpeedFactor();
 
     this->emulationThread->SetRomFile(cartRom);
     this->emulationThread->SetDiskFile(diskRom);
@@ -474,6 +574,7 @@ void MainWindow::ui_Actions_Init(void)
     this->action_System_HardReset = new QAction(this);
     this->action_System_Pause = new QAction(this);
     this->action_System_GenerateBitmap = new QAction(this);
+    this->action_System_RecordVideo = new QAction(this);
     this->action_System_LimitFPS = new QAction(this);
     this->action_System_SwapDisk = new QAction(this);
     this->action_System_SaveState = new QAction(this);
@@ -536,6 +637,11 @@ void MainWindow::ui_Actions_Setup(bool inEmulation, bool isPaused)
     keyBinding = QString::fromStdString(CoreSettingsGetStringValue(SettingsID::KeyBinding_GenerateBitmap));
     this->action_System_GenerateBitmap->setText("Generate Bitmap");
     this->action_System_GenerateBitmap->setShortcut(QKeySequence(keyBinding));
+    keyBinding = QString::fromStdString(CoreSettingsGetStringValue(SettingsID::KeyBinding_RecordVideo));
+    this->action_System_RecordVideo->setText("Record Video");
+    this->action_System_RecordVideo->setShortcut(QKeySequence(keyBinding));
+    this->action_System_RecordVideo->setCheckable(true);
+    this->action_System_RecordVideo->setChecked(VidExtIsRecording());
     keyBinding = QString::fromStdString(CoreSettingsGetStringValue(SettingsID::KeyBinding_LimitFPS));
     this->action_System_LimitFPS->setText("Limit FPS");
     this->action_System_LimitFPS->setShortcut(QKeySequence(keyBinding));
@@ -597,6 +703,7 @@ void MainWindow::ui_Actions_Add(void)
     this->addAction(this->action_System_HardReset);
     this->addAction(this->action_System_Pause);
     this->addAction(this->action_System_GenerateBitmap);
+    this->addAction(this->action_System_RecordVideo);
     this->addAction(this->action_System_LimitFPS);
     this->addAction(this->action_System_SwapDisk);
     this->addAction(this->action_System_SaveState);
@@ -627,6 +734,7 @@ void MainWindow::ui_Actions_Remove(void)
     this->removeAction(this->action_System_HardReset);
     this->removeAction(this->action_System_Pause);
     this->removeAction(this->action_System_GenerateBitmap);
+    this->removeAction(this->action_System_RecordVideo);
     this->removeAction(this->action_System_LimitFPS);
     this->removeAction(this->action_System_SwapDisk);
     this->removeAction(this->action_System_SaveState);
@@ -659,6 +767,7 @@ void MainWindow::ui_Actions_Connect(void)
     connect(this->action_System_Pause, &QAction::triggered, this, &MainWindow::on_Action_System_Pause);
     connect(this->action_System_GenerateBitmap, &QAction::triggered, this,
             &MainWindow::on_Action_System_GenerateBitmap);
+    connect(this->action_System_RecordVideo, &QAction::triggered, this, &MainWindow::on_Action_System_RecordVideo);
     connect(this->action_System_LimitFPS, &QAction::triggered, this, &MainWindow::on_Action_System_LimitFPS);
     connect(this->action_System_SwapDisk, &QAction::triggered, this, &MainWindow::on_Action_System_SwapDisk);
     connect(this->action_System_SaveState, &QAction::triggered, this, &MainWindow::on_Action_System_SaveState);
@@ -693,6 +802,49 @@ void MainWindow::on_EventFilter_KeyPressed(QKeyEvent *event)
         return;
     }
 
+    // rewind while the key is held
+    if (this->ui_IsKeyBinding(event, SettingsID::KeyBinding_Rewind) && CoreIsRewindEnabled())
+    {
+        if (!event->isAutoRepeat())
+        {
+            CoreSetRewinding(true);
+        }
+        return;
+    }
+
+    // fast forward while the key is held
+    if (this->ui_IsKeyBinding(event, SettingsID::KeyBinding_FastForwardHold))
+    {
+        if (!event->isAutoRepeat())
+        {
+            this->ui_FastForwardHeld = true;
+            this->ui_UpdateSpeedFactor();
+        }
+        return;
+    }
+
+    if (this->ui_IsKeyBinding(event, SettingsID::KeyBinding_FastForwardToggle))
+    {
+        if (!event->isAutoRepeat())
+        {
+            this->ui_FastForwardToggled = !this->ui_FastForwardToggled;
+            this->ui_SlowMotionToggled = false;
+            this->ui_UpdateSpeedFactor();
+        }
+        return;
+    }
+
+    if (this->ui_IsKeyBinding(event, SettingsID::KeyBinding_SlowMotionToggle))
+    {
+        if (!event->isAutoRepeat())
+        {
+            this->ui_SlowMotionToggled = !this->ui_SlowMotionToggled;
+            this->ui_FastForwardToggled = false;
+            this->ui_UpdateSpeedFactor();
+        }
+        return;
+    }
+
     int key = Utilities::QtKeyToSdl2Key(event->key());
     int mod = Utilities::QtModKeyToSdl2ModKey(event->modifiers());
 
@@ -707,6 +859,32 @@ void MainWindow::on_EventFilter_KeyReleased(QKeyEvent *event)
         return;
     }
 
+    if (this->ui_IsKeyBinding(event, SettingsID::KeyBinding_Rewind) && CoreIsRewindEnabled())
+    {
+        if (!event->isAutoRepeat())
+        {
+            CoreSetRewinding(false);
+        }
+        return;
+    }
+
+    if (this->ui_IsKeyBinding(event, SettingsID::KeyBinding_FastForwardHold))
+    {
+        if (!event->isAutoRepeat())
+        {
+            this->ui_FastForwardHeld = false;
+            this->ui_UpdateSpeedFactor();
+        }
+        return;
+    }
+
+    // the toggles only act on key presses
+    if (this->ui_IsKeyBinding(event, SettingsID::KeyBinding_FastForwardToggle) ||
+        this->ui_IsKeyBinding(event, SettingsID::KeyBinding_SlowMotionToggle))
+    {
+        return;
+    }
+
     int key = Utilities::QtKeyToSdl2Key(event->key());
     int mod = Utilities::QtModKeyToSdl2ModKey(event->modifiers());
 
@@ -733,6 +911,17 @@ void MainWindow::on_EventFilter_FileDropped(QDropEvent *event)
     this->emulationThread_Launch(file);
 }
 
+void MainWindow::on_PluginLoader_Finished(bool success)
+{
+    if (!success)
+    {
+        this->ui_MessageBox("Error", "CoreApplyPluginSettings() Failed", this->pluginLoaderThread->GetLastError());
+        return;
+    }
+
+    CoreTrace("MainWindow: plugins loaded");
+}
+
 /* TODO for some day
 void MainWindow::on_EventFilter_FocusIn(QFocusEvent *event)
 {
@@ -943,6 +1132,41 @@ void MainWindow::on_Action_System_GenerateBitmap(void)
     }
 }
 
+void MainWindow::on_Action_System_RecordVideo(void)
+{
+    if (VidExtIsRecording())
+    {
+        VidExtStopRecording();
+        this->action_System_RecordVideo->setChecked(false);
+        return;
+    }
+
+    CoreRomSettings settings;
+    QString directory, name;
+
+    directory = QString::fromStdString(CoreSettingsGetStringValue(SettingsID::GUI_RecordingDirectory));
+    QDir().mkpath(directory);
+
+    CoreGetCurrentRomSettings(settings);
+    name = QString::fromStdString(settings.GoodName);
+    name.replace(QRegularExpression("[^A-Za-z0-9 ()_-]"), "");
+    if (name.isEmpty())
+    {
+        name = "Recording";
+    }
+
+    name += " - " + QDateTime::currentDateTime().toString("yyyy-MM-dd hh-mm-ss");
+
+    if (!VidExtStartRecording(QDir(directory).filePath(name)))
+    {
+        this->action_System_RecordVideo->setChecked(false);
+        this->ui_MessageBox("Error", "VidExtStartRecording() Failed!", QString::fromStdString(CoreGetError()));
+        return;
+    }
+
+    this->action_System_RecordVideo->setChecked(true);
+}
+
 void MainWindow::on_Action_System_LimitFPS(void)
 {
     bool enabled, ret;
@@ -1054,21 +1278,25 @@ void MainWindow::on_Action_Options_FullScreen(void)
 
 void MainWindow::on_Action_Options_ConfigGfx(void)
 {
+    this->pluginLoaderThread_Wait();
     CorePluginsOpenConfig(CorePluginType::Gfx);
 }
 
 void MainWindow::on_Action_Options_ConfigAudio(void)
 {
+    this->pluginLoaderThread_Wait();
     CorePluginsOpenConfig(CorePluginType::Audio);
 }
 
 void MainWindow::on_Action_Options_ConfigRsp(void)
 {
+    this->pluginLoaderThread_Wait();
     CorePluginsOpenConfig(CorePluginType::Rsp);
 }
 
 void MainWindow::on_Action_Options_ConfigControl(void)
 {
+    this->pluginLoaderThread_Wait();
     CorePluginsOpenConfig(CorePluginType::Input);
 }
 
@@ -1082,6 +1310,9 @@ void MainWindow::on_Action_Options_Settings(void)
         this->on_Action_System_Pause();
     }
 
+    // the dialog uses the plugins and the core's config
+    this->pluginLoaderThread_Wait();
+
     Dialog::SettingsDialog dialog(this);
     dialog.exec();
 
@@ -1111,6 +1342,11 @@ void MainWindow::on_Emulation_Started(void)
 
 void MainWindow::on_Emulation_Finished(bool ret)
 {
+    if (VidExtIsRecording())
+    {
+        VidExtStopRecording();
+    }
+
     if (!ret)
     {
         this->ui_MessageBox("Error", "EmulationThread::run Failed", this->emulationThread->GetLastError());
@@ -1134,8 +1370,9 @@ void MainWindow::on_RomBrowser_Selected(QString file)
     this->emulationThread_Launch(file);
 }
 
-void MainWindow::on_VidExt_Init(void)
+void MainWindow::on_VidExt_Init(VidExtRenderMode renderMode)
 {
+    this->ui_VidExtRenderMode = renderMode;
     this->ui_VidExt_Geometry_Saved = false;
     this->ui_VidExtForceSetMode = true;
 
@@ -1144,8 +1381,15 @@ void MainWindow::on_VidExt_Init(void)
 
 void MainWindow::on_VidExt_SetupOGL(QSurfaceFormat format, QThread* thread)
 {
-    this->ui_Widget_OpenGL->MoveToThread(thread);
     this->ui_Widget_OpenGL->setFormat(format);
+    this->ui_Widget_OpenGL->MoveToThread(thread);
+}
+
+void MainWindow::on_VidExt_SetupVK(void)
+{
+#if QT_CONFIG(vulkan)
+    this->ui_Widget_Vulkan->SetupNativeWindow();
+#endif // QT_CONFIG(vulkan)
 }
 
 void MainWindow::on_VidExt_SetMode(int width, int height, int bps, int mode, int flags)
@@ -1161,8 +1405,12 @@ void MainWindow::on_VidExt_SetWindowedModeWithRate(int width, int height, int re
         this->restoreGeometry(this->ui_VidExt_Geometry);
         this->ui_VidExt_Geometry_Saved = false;
 
-        // force 'refresh' the video plugin
-        CoreSetVideoSize(width, height);
+        // without manual resizing the widget doesn't
+        // pass the new size on, so force 'refresh' the video plugin
+        if (!this->ui_AllowManualResizing)
+        {
+            CoreSetVideoSize(width, height);
+        }
     }
 
     if (this->isFullScreen())
@@ -1192,12 +1440,17 @@ void MainWindow::on_VidExt_SetFullscreenModeWithRate(int width, int height, int
         this->ui_VidExt_Geometry = this->saveGeometry();
         this->ui_VidExt_Geometry_Saved = true;
 
-        // force 'refresh' the video plugin
-        CoreSetVideoSize(width, height);
+        // without manual resizing the widget doesn't
+        // pass the new size on, so force 'refresh' the video plugin
+        if (!this->ui_AllowManualResizing)
+        {
+            CoreSetVideoSize(width, height);
+        }
     }
 
     if (!this->isFullScreen())
     {
+        this->ui_MoveToFullscreenScreen();
         this->showFullScreen();
     }
 
@@ -1217,6 +1470,10 @@ void MainWindow::on_VidExt_SetFullscreenModeWithRate(int width, int height, int
 
 void MainWindow::on_VidExt_ResizeWindow(int width, int height)
 {
+    // the video plugin renders at this size now
+    this->ui_Widget_OpenGL->SetVideoSize(width, height);
+    this->ui_Widget_Vulkan->SetVideoSize(width, height);
+
     // account for HiDPI scaling
     // see https://github.com/Rosalie241/RMG/issues/2
     height /= this->devicePixelRatioF();
@@ -1269,6 +1526,7 @@ void MainWindow::on_VidExt_ToggleFS(bool fullscreen)
     {
         if (!this->isFullScreen())
         {
+            this->ui_MoveToFullscreenScreen();
             this->showFullScreen();
         }
 
@@ -1306,6 +1564,11 @@ void MainWindow::on_VidExt_ToggleFS(bool fullscreen)
 
 }
 
+void MainWindow::on_VidExt_ListScreenModes(QList<QSize>* sizes, QList<int>* rates)
+{
+    VidExtGetScreenModes(*sizes, *rates);
+}
+
 void MainWindow::on_VidExt_Quit(void)
 {
 }
@@ -1346,3 +1609,28 @@ void MainWindow::on_Core_DebugCallback(CoreDebugMessageType type, QString messag
     this->ui_TimerId = this->startTimer(this->ui_TimerTimeout * 1000);
 }
 
+void MainWindow::on_Core_StateCallback(CoreStateCallbackType type, int value)
+{
+    // save states which are written in the background
+    // only report whether they've been written here
+    if (type != CoreStateCallbackType::SaveStateComplete)
+    {
+        return;
+    }
+
+    if (value == 0)
+    {
+        this->ui_MessageBox("Error", "Failed to save state", QString::fromStdString(CoreGetSaveStateError()));
+        return;
+    }
+
+    this->ui_StatusBar_Label->setText("Saved state");
+
+    // reset label deletion timer
+    if (this->ui_TimerId != 0)
+    {
+        this->killTimer(this->ui_TimerId);
+    }
+    this->ui_TimerId = this->startTimer(this->ui_TimerTimeout * 1000);
+}
+
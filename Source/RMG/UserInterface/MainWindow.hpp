@@ -11,9 +11,11 @@
 #define MAINWINDOW_HPP
 
 #include "Thread/EmulationThread.hpp"
+#include "Thread/PluginLoaderThread.hpp"
 #include "Dialog/SettingsDialog.hpp"
 #include "EventFilter.hpp"
 #include "Widget/OGLWidget.hpp"
+#include "Widget/VKWidget.hpp"
 #include "Widget/RomBrowserWidget.hpp"
 #include "Callbacks.hpp"
 
@@ -41,11 +43,13 @@ class MainWindow : public QMainWindow
     QIcon ui_Icon;
 
     Thread::EmulationThread *emulationThread;
+    Thread::PluginLoaderThread *pluginLoaderThread;
 
     CoreCallbacks* coreCallBacks;
 
     QStackedWidget *ui_Widgets;
     Widget::OGLWidget *ui_Widget_OpenGL;
+    Widget::VKWidget *ui_Widget_Vulkan;
     Widget::RomBrowserWidget *ui_Widget_RomBrowser;
     EventFilter *ui_EventFilter;
     QLabel *ui_StatusBar_Label;
@@ -67,6 +71,7 @@ class MainWindow : public QMainWindow
     QAction *action_System_HardReset;
     QAction *action_System_Pause;
     QAction *action_System_GenerateBitmap;
+    QAction *action_System_RecordVideo;
     QAction *action_System_LimitFPS;
     QAction *action_System_SwapDisk;
     QAction *action_System_SaveState;
@@ -95,7 +100,11 @@ class MainWindow : public QMainWindow
     bool ui_HideCursorInEmulation;
     bool ui_NoSwitchToRomBrowser = false;
     bool ui_VidExtForceSetMode;
+    VidExtRenderMode ui_VidExtRenderMode = VidExtRenderMode::OpenGL;
     bool ui_RefreshRomListAfterEmulation = false;
+    bool ui_FastForwardHeld = false;
+    bool ui_FastForwardToggled = false;
+    bool ui_SlowMotionToggled = false;
 
 
     int ui_TimerId = 0;
@@ -110,6 +119,9 @@ class MainWindow : public QMainWindow
     void ui_InEmulation(bool, bool);
     void ui_SaveGeometry(void);
     void ui_LoadGeometry(void);
+    void ui_MoveToFullscreenScreen(void);
+    bool ui_IsKeyBinding(QKeyEvent *, SettingsID);
+    void ui_UpdateSpeedFactor(void);
 
     void menuBar_Init(void);
     void menuBar_Setup(bool, bool);
@@ -119,6 +131,9 @@ class MainWindow : public QMainWindow
     void emulationThread_Launch(QString, QString);
     void emulationThread_Launch(QString);
 
+    void pluginLoaderThread_Init(void);
+    void pluginLoaderThread_Wait(void);
+
     void ui_Actions_Init(void);
     void ui_Actions_Setup(bool, bool);
     void ui_Actions_Add(void);
@@ -133,6 +148,8 @@ class MainWindow : public QMainWindow
     void on_EventFilter_KeyReleased(QKeyEvent *);
     void on_EventFilter_FileDropped(QDropEvent *);
 
+    void on_PluginLoader_Finished(bool);
+
     void on_Action_File_OpenRom(void);
     void on_Action_File_OpenCombo(void);
     void on_Action_File_EndEmulation(void);
@@ -143,6 +160,7 @@ class MainWindow : public QMainWindow
     void on_Action_System_HardReset(void);
     void on_Action_System_Pause(void);
     void on_Action_System_GenerateBitmap(void);
+    void on_Action_System_RecordVideo(void);
     void on_Action_System_LimitFPS(void);
     void on_Action_System_SwapDisk(void);
     void on_Action_System_SaveState(void);
@@ -168,17 +186,20 @@ class MainWindow : public QMainWindow
 
   public slots:
 
-    void on_VidExt_Init(void);
+    void on_VidExt_Init(VidExtRenderMode);
     void on_VidExt_SetupOGL(QSurfaceFormat, QThread *);
+    void on_VidExt_SetupVK(void);
     void on_VidExt_SetMode(int, int, int, int, int);
     void on_VidExt_SetWindowedModeWithRate(int, int, int, int, int);
     void on_VidExt_SetFullscreenModeWithRate(int, int, int, int, int);
     void on_VidExt_ResizeWindow(int, int);
     void on_VidExt_SetCaption(QString);
     void on_VidExt_ToggleFS(bool);
+    void on_VidExt_ListScreenModes(QList<QSize> *, QList<int> *);
     void on_VidExt_Quit(void);
 
     void on_Core_DebugCallback(CoreDebugMessageType, QString);
+    void on_Core_StateCallback(CoreStateCallbackType, int);
 };
 } // namespace UserInterface
 
@@ -3,6 +3,8 @@
 using namespace UserInterface::Widget;
 
 #include <iostream>
+#include "VidExt.hpp"
+
 #include <RMG-Core/Core.hpp>
 
 OGLWidget::OGLWidget(QWidget *parent)
@@ -19,11 +21,32 @@ void OGLWidget::MoveToThread(QThread *thread)
 {
     this->doneCurrent();
 
-    this->context()->create();
+    // only (re)create the context when it doesn't exist
+    // yet or when the requested format has changed,
+    // otherwise keep using the same context, moving
+    // it between threads is cheap
+    if (!this->context()->isValid() || this->contextFormat != this->requestedFormat())
+    {
+        this->context()->setFormat(this->requestedFormat());
+        this->context()->create();
+        this->contextFormat = this->requestedFormat();
+
+        this->offscreenSurface.destroy();
+        this->offscreenSurface.setFormat(this->context()->format());
+        this->offscreenSurface.create();
+    }
 
     this->context()->moveToThread(thread);
 }
 
+void OGLWidget::SetVideoSize(int width, int height)
+{
+    // the video plugin already renders at this size,
+    // so a resize to it doesn't need to be forwarded
+    this->videoWidth = width;
+    this->videoHeight = height;
+}
+
 void OGLWidget::SetAllowResizing(bool value)
 {
     this->allowResizing = value;
@@ -34,6 +57,11 @@ void OGLWidget::SetHideCursor(bool value)
     this->setCursor(value ? Qt::BlankCursor : Qt::ArrowCursor);
 }
 
+QOffscreenSurface *OGLWidget::GetOffscreenSurface(void)
+{
+    return &this->offscreenSurface;
+}
+
 QWidget *OGLWidget::GetWidget(void)
 {
     QWidget *widget = QWidget::createWindowContainer(this);
@@ -41,14 +69,28 @@ QWidget *OGLWidget::GetWidget(void)
     return widget;
 }
 
+QSize OGLWidget::GetFramebufferSize(void)
+{
+    return this->framebufferSize;
+}
+
 void OGLWidget::exposeEvent(QExposeEvent *)
 {
+    // the window might be exposed
+    // before it receives a resize event
+    this->framebufferSize = QSize(this->QOpenGLWindow::width() * this->devicePixelRatio(),
+                                  this->QOpenGLWindow::height() * this->devicePixelRatio());
 }
 
 void OGLWidget::resizeEvent(QResizeEvent *event)
 {
     QOpenGLWindow::resizeEvent(event);
 
+    // published for the render thread,
+    // which can't query the window itself
+    this->framebufferSize = QSize(event->size().width() * this->devicePixelRatio(),
+                                  event->size().height() * this->devicePixelRatio());
+
     if (!this->allowResizing)
         return;
 
@@ -68,10 +110,23 @@ void OGLWidget::resizeEvent(QResizeEvent *event)
 
 void OGLWidget::timerEvent(QTimerEvent *event)
 {
-    CoreSetVideoSize(this->width, this->height);
-
     // remove current timer
     this->killTimer(this->timerId);
     this->timerId = 0;
     this->requestActivate();
+
+    // only make the video plugin re-allocate
+    // its render targets when the size changed
+    if (this->width == this->videoWidth &&
+        this->height == this->videoHeight)
+    {
+        return;
+    }
+
+    if (CoreSetVideoSize(this->width, this->height))
+    {
+        this->videoWidth = this->width;
+        this->videoHeight = this->height;
+        VidExtSetWindowSize(this->width, this->height);
+    }
 }
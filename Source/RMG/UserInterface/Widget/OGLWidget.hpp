@@ -1,13 +1,17 @@
 #ifndef OGLWIDGET_HPP
 #define OGLWIDGET_HPP
 
+#include <QOffscreenSurface>
 #include <QOpenGLWidget>
 #include <QOpenGLWindow>
 #include <QResizeEvent>
+#include <QSurfaceFormat>
 #include <QThread>
 #include <QTimerEvent>
 #include <QWidget>
 
+#include <atomic>
+
 namespace UserInterface
 {
 namespace Widget
@@ -19,11 +23,20 @@ class OGLWidget : public QOpenGLWindow
     ~OGLWidget(void);
 
     void MoveToThread(QThread *);
+    void SetVideoSize(int, int);
     void SetAllowResizing(bool);
     void SetHideCursor(bool);
 
+    // returns an offscreen surface which
+    // is compatible with the context
+    QOffscreenSurface *GetOffscreenSurface(void);
+
     QWidget *GetWidget(void);
 
+    // returns the size of the framebuffer in pixels,
+    // safe to call from the render thread
+    QSize GetFramebufferSize(void);
+
   protected:
     void exposeEvent(QExposeEvent *) Q_DECL_OVERRIDE;
     void resizeEvent(QResizeEvent *) Q_DECL_OVERRIDE;
@@ -32,9 +45,15 @@ class OGLWidget : public QOpenGLWindow
   private:
     QWidget *parent;
     bool allowResizing = false;
-    int width;
-    int height;
+    int width = 0;
+    int height = 0;
+    int videoWidth = 0;
+    int videoHeight = 0;
     int timerId;
+    std::atomic<QSize> framebufferSize;
+
+    QSurfaceFormat contextFormat;
+    QOffscreenSurface offscreenSurface;
 };
 } // namespace Widget
 } // namespace UserInterface
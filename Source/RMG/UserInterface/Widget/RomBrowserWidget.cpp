@@ -233,6 +233,8 @@ void RomBrowserWidget::romSearcher_Launch(QString directory)
     this->romSearcher_Thread->SetMaximumFiles(CoreSettingsGetIntValue(SettingsID::RomBrowser_MaxItems));
     this->romSearcher_Thread->SetRecursive(CoreSettingsGetBoolValue(SettingsID::RomBrowser_Recursive));
     this->romSearcher_Thread->SetDirectory(directory);
+    // the core's config can't be used on the searcher thread
+    this->romSearcher_Thread->SetRomDatabaseFile(QString::fromStdString(CoreGetRomDatabaseFile()));
     this->romSearcher_Thread->start();
 }
 
@@ -241,7 +243,10 @@ void RomBrowserWidget::column_SetSize(void)
     int index = 0;
     int columnCount = (this->model_Model->columnCount() - 1);
 
-    std::vector<int> sizes = CoreSettingsGetIntListValue(SettingsID::RomBrowser_ColumnSizes);
+    // keep the sizes around so resizing
+    // a column doesn't have to retrieve them
+    this->column_Sizes = CoreSettingsGetIntListValue(SettingsID::RomBrowser_ColumnSizes);
+    const std::vector<int>& sizes = this->column_Sizes;
 
     for (int id : this->model_Columns)
     {
@@ -264,7 +269,7 @@ void RomBrowserWidget::column_SetSize(void)
 
 int RomBrowserWidget::column_GetSizeSettingIndex(int column)
 {
-    std::vector<int> sizes = CoreSettingsGetIntListValue(SettingsID::RomBrowser_ColumnSizes);
+    const std::vector<int>& sizes = this->column_Sizes;
 
     for (int id : this->model_Columns)
     {
@@ -321,20 +326,25 @@ void RomBrowserWidget::customContextMenuRequested(QPoint position)
 
 void RomBrowserWidget::on_columnResized(int column, int oldWidth, int newWidth)
 {
-    std::vector<int> sizes = CoreSettingsGetIntListValue(SettingsID::RomBrowser_ColumnSizes);
-
     int sizeIndex = this->column_GetSizeSettingIndex(column);
 
     // when we've failed to find the setting index,
     // return because that shouldn't happen
-    if (sizeIndex == -1)
+    if (sizeIndex == -1 || sizeIndex >= (int)this->column_Sizes.size())
+    {
+        return;
+    }
+
+    if (this->column_Sizes[sizeIndex] == newWidth)
     {
         return;
     }
 
-    sizes[sizeIndex] = newWidth;
+    this->column_Sizes[sizeIndex] = newWidth;
 
-    CoreSettingsSetValue(SettingsID::RomBrowser_ColumnSizes, sizes);
+    // only updates the setting in memory,
+    // it's saved when the settings are saved
+    CoreSettingsSetValue(SettingsID::RomBrowser_ColumnSizes, this->column_Sizes);
 }
 
 void RomBrowserWidget::on_Action_PlayGame(void)
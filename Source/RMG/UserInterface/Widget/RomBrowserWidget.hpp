@@ -75,6 +75,7 @@ class RomBrowserWidget : public QTableView
     void romSearcher_Init(void);
     void romSearcher_Launch(QString);
 
+    std::vector<int> column_Sizes;
     void column_SetSize();
     int column_GetSizeSettingIndex(int);
 
@@ -0,0 +1,267 @@
+#include "VKWidget.hpp"
+
+using namespace UserInterface::Widget;
+
+#include "VidExt.hpp"
+
+#include <RMG-Core/Core.hpp>
+
+#if QT_CONFIG(vulkan)
+#include <QGuiApplication>
+#include <QLibrary>
+// winId() is enough on Windows and macOS, xcb and wayland
+// need the display connection and wayland needs the surface,
+// which Qt only exposes through its platform native interface
+#if defined(Q_OS_UNIX) && !defined(Q_OS_MACOS)
+#define VKWIDGET_NATIVE_INTERFACE
+#include <qpa/qplatformnativeinterface.h>
+#endif // Q_OS_UNIX && !Q_OS_MACOS
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif // Q_OS_WIN
+
+// the platform specific Vulkan headers need the headers
+// of the windowing systems, so the create info structures
+// are declared here, they match the Vulkan specification
+struct VkXcbSurfaceCreateInfo
+{
+    VkStructureType sType;
+    const void *pNext;
+    VkFlags flags;
+    void *connection;
+    uint32_t window;
+};
+
+struct VkWaylandSurfaceCreateInfo
+{
+    VkStructureType sType;
+    const void *pNext;
+    VkFlags flags;
+    void *display;
+    void *surface;
+};
+
+struct VkWin32SurfaceCreateInfo
+{
+    VkStructureType sType;
+    const void *pNext;
+    VkFlags flags;
+    void *hinstance;
+    void *hwnd;
+};
+
+struct VkMacOSSurfaceCreateInfo
+{
+    VkStructureType sType;
+    const void *pNext;
+    VkFlags flags;
+    const void *view;
+};
+
+typedef VkResult(VKAPI_PTR *ptr_vkCreateSurface)(VkInstance, const void *, const VkAllocationCallbacks *,
+                                                 VkSurfaceKHR *);
+
+// retrieves vkGetInstanceProcAddr from the Vulkan loader,
+// which has already been loaded by the video plugin
+static PFN_vkGetInstanceProcAddr get_instance_proc_addr(void)
+{
+    static QLibrary library;
+    static PFN_vkGetInstanceProcAddr function = nullptr;
+
+    if (function != nullptr)
+    {
+        return function;
+    }
+
+#ifdef Q_OS_WIN
+    library.setFileName("vulkan-1");
+#else
+    library.setFileNameAndVersion("vulkan", 1);
+#endif // Q_OS_WIN
+    function = (PFN_vkGetInstanceProcAddr)library.resolve("vkGetInstanceProcAddr");
+
+#ifdef Q_OS_MACOS
+    // MoltenVK can be used without loader
+    if (function == nullptr)
+    {
+        library.setFileName("MoltenVK");
+        function = (PFN_vkGetInstanceProcAddr)library.resolve("vkGetInstanceProcAddr");
+    }
+#endif // Q_OS_MACOS
+
+    return function;
+}
+
+static VkSurfaceKHR create_surface(VkInstance instance, const char *function, const void *createInfo)
+{
+    PFN_vkGetInstanceProcAddr getInstanceProcAddr = get_instance_proc_addr();
+    ptr_vkCreateSurface createSurface;
+    VkSurfaceKHR surface = VK_NULL_HANDLE;
+
+    if (getInstanceProcAddr == nullptr)
+    {
+        return VK_NULL_HANDLE;
+    }
+
+    createSurface = (ptr_vkCreateSurface)getInstanceProcAddr(instance, function);
+    if (createSurface == nullptr || createSurface(instance, createInfo, nullptr, &surface) != VK_SUCCESS)
+    {
+        return VK_NULL_HANDLE;
+    }
+
+    return surface;
+}
+#endif // QT_CONFIG(vulkan)
+
+VKWidget::VKWidget(QWidget *parent)
+{
+    this->parent = parent;
+    this->timerId = 0;
+
+    this->setSurfaceType(QSurface::VulkanSurface);
+}
+
+VKWidget::~VKWidget(void)
+{
+}
+
+#if QT_CONFIG(vulkan)
+bool VKWidget::SetupNativeWindow(void)
+{
+    this->platform = QGuiApplication::platformName();
+    // creates the native window when needed
+    this->nativeWindow = this->winId();
+    this->nativeDisplay = nullptr;
+    this->nativeSurface = nullptr;
+
+#ifdef VKWIDGET_NATIVE_INTERFACE
+    QPlatformNativeInterface *nativeInterface = QGuiApplication::platformNativeInterface();
+    if (nativeInterface == nullptr)
+    {
+        return false;
+    }
+
+    if (this->platform == "xcb")
+    {
+        this->nativeDisplay = nativeInterface->nativeResourceForIntegration("connection");
+    }
+    else if (this->platform.startsWith("wayland"))
+    {
+        this->nativeDisplay = nativeInterface->nativeResourceForIntegration("wl_display");
+        this->nativeSurface = nativeInterface->nativeResourceForWindow("surface", this);
+    }
+#endif // VKWIDGET_NATIVE_INTERFACE
+
+    return this->nativeWindow != 0;
+}
+
+VkSurfaceKHR VKWidget::CreateSurface(VkInstance instance)
+{
+    if (this->nativeWindow == 0)
+    {
+        return VK_NULL_HANDLE;
+    }
+
+    if (this->platform == "xcb")
+    {
+        VkXcbSurfaceCreateInfo createInfo = {VK_STRUCTURE_TYPE_XCB_SURFACE_CREATE_INFO_KHR, nullptr, 0,
+                                             this->nativeDisplay, (uint32_t)this->nativeWindow};
+        return create_surface(instance, "vkCreateXcbSurfaceKHR", &createInfo);
+    }
+    else if (this->platform.startsWith("wayland"))
+    {
+        VkWaylandSurfaceCreateInfo createInfo = {VK_STRUCTURE_TYPE_WAYLAND_SURFACE_CREATE_INFO_KHR, nullptr, 0,
+                                                 this->nativeDisplay, this->nativeSurface};
+        return create_surface(instance, "vkCreateWaylandSurfaceKHR", &createInfo);
+    }
+#ifdef Q_OS_WIN
+    else if (this->platform == "windows")
+    {
+        VkWin32SurfaceCreateInfo createInfo = {VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR, nullptr, 0,
+                                               (void *)GetModuleHandleW(nullptr), (void *)this->nativeWindow};
+        return create_surface(instance, "vkCreateWin32SurfaceKHR", &createInfo);
+    }
+#endif // Q_OS_WIN
+    else if (this->platform == "cocoa")
+    {
+        VkMacOSSurfaceCreateInfo createInfo = {VK_STRUCTURE_TYPE_MACOS_SURFACE_CREATE_INFO_MVK, nullptr, 0,
+                                               (const void *)this->nativeWindow};
+        return create_surface(instance, "vkCreateMacOSSurfaceMVK", &createInfo);
+    }
+
+    return VK_NULL_HANDLE;
+}
+#endif // QT_CONFIG(vulkan)
+
+void VKWidget::SetVideoSize(int width, int height)
+{
+    // the video plugin already renders at this size,
+    // so a resize to it doesn't need to be forwarded
+    this->videoWidth = width;
+    this->videoHeight = height;
+}
+
+void VKWidget::SetAllowResizing(bool value)
+{
+    this->allowResizing = value;
+}
+
+void VKWidget::SetHideCursor(bool value)
+{
+    this->setCursor(value ? Qt::BlankCursor : Qt::ArrowCursor);
+}
+
+QWidget *VKWidget::GetWidget(void)
+{
+    QWidget *widget = QWidget::createWindowContainer(this);
+    widget->setParent(this->parent);
+    return widget;
+}
+
+void VKWidget::exposeEvent(QExposeEvent *)
+{
+}
+
+void VKWidget::resizeEvent(QResizeEvent *event)
+{
+    QWindow::resizeEvent(event);
+
+    if (!this->allowResizing)
+        return;
+
+    if (this->timerId != 0)
+    {
+        this->killTimer(this->timerId);
+        this->timerId = 0;
+    }
+
+    this->timerId = this->startTimer(100);
+
+    // account for HiDPI scaling
+    // see https://github.com/Rosalie241/RMG/issues/2
+    this->width = event->size().width() * this->devicePixelRatio();
+    this->height = event->size().height() * this->devicePixelRatio();
+}
+
+void VKWidget::timerEvent(QTimerEvent *event)
+{
+    // remove current timer
+    this->killTimer(this->timerId);
+    this->timerId = 0;
+    this->requestActivate();
+
+    // only make the video plugin re-create
+    // its swapchain when the size changed
+    if (this->width == this->videoWidth &&
+        this->height == this->videoHeight)
+    {
+        return;
+    }
+
+    if (CoreSetVideoSize(this->width, this->height))
+    {
+        this->videoWidth = this->width;
+        this->videoHeight = this->height;
+        VidExtSetWindowSize(this->width, this->height);
+    }
+}
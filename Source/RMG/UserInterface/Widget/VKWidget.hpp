@@ -0,0 +1,68 @@
+#ifndef VKWIDGET_HPP
+#define VKWIDGET_HPP
+
+#include <QResizeEvent>
+#include <QTimerEvent>
+#include <QWidget>
+#include <QWindow>
+#if QT_CONFIG(vulkan)
+#include <vulkan/vulkan.h>
+#endif // QT_CONFIG(vulkan)
+
+namespace UserInterface
+{
+namespace Widget
+{
+class VKWidget : public QWindow
+{
+  public:
+    VKWidget(QWidget *);
+    ~VKWidget(void);
+
+#if QT_CONFIG(vulkan)
+    // creates the native window and retrieves the
+    // handles needed to create a surface for it,
+    // must be called on the GUI thread
+    bool SetupNativeWindow(void);
+
+    // creates a surface for the window on the given (plugin owned)
+    // instance with vkCreate*SurfaceKHR, so Qt doesn't own it, the
+    // video plugin destroys it before it destroys the instance,
+    // can be called from any thread after SetupNativeWindow(),
+    // returns VK_NULL_HANDLE on failure
+    VkSurfaceKHR CreateSurface(VkInstance);
+#endif // QT_CONFIG(vulkan)
+
+    void SetVideoSize(int, int);
+    void SetAllowResizing(bool);
+    void SetHideCursor(bool);
+
+    QWidget *GetWidget(void);
+
+  protected:
+    void exposeEvent(QExposeEvent *) Q_DECL_OVERRIDE;
+    void resizeEvent(QResizeEvent *) Q_DECL_OVERRIDE;
+    void timerEvent(QTimerEvent *) Q_DECL_OVERRIDE;
+
+  private:
+    QWidget *parent;
+    bool allowResizing = false;
+    int width = 0;
+    int height = 0;
+    int videoWidth = 0;
+    int videoHeight = 0;
+    int timerId;
+
+#if QT_CONFIG(vulkan)
+    QString platform;
+    WId nativeWindow = 0;
+    // xcb_connection_t or wl_display
+    void *nativeDisplay = nullptr;
+    // wl_surface
+    void *nativeSurface = nullptr;
+#endif // QT_CONFIG(vulkan)
+};
+} // namespace Widget
+} // namespace UserInterface
+
+#endif // VKWIDGET_HPP
@@ -0,0 +1,582 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "VideoRecorder.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VIDEORECORDER_SSE2
+#endif
+
+using namespace Utilities;
+
+//
+// Local Defines
+//
+
+// amount of frames which can be queued
+// before frames start getting dropped
+#define FRAME_SLOTS 8
+// amount of conversion threads
+#define WORKER_THREADS 2
+// maximum amount of queued audio
+#define AUDIO_BUFFER_MAX (8 * 1024 * 1024)
+
+//
+// Local Functions
+//
+
+// BT.601 limited range coefficients (8-bit fixed point)
+#define Y_R 66
+#define Y_G 129
+#define Y_B 25
+#define U_R -38
+#define U_G -74
+#define U_B 112
+#define V_R 112
+#define V_G -94
+#define V_B -18
+
+static inline uint8_t rgb_to_y(int r, int g, int b)
+{
+    return (uint8_t)(((Y_R * r + Y_G * g + Y_B * b + 128) >> 8) + 16);
+}
+
+static inline uint8_t rgb_to_u(int r, int g, int b)
+{
+    return (uint8_t)(((U_R * r + U_G * g + U_B * b + 128) >> 8) + 128);
+}
+
+static inline uint8_t rgb_to_v(int r, int g, int b)
+{
+    return (uint8_t)(((V_R * r + V_G * g + V_B * b + 128) >> 8) + 128);
+}
+
+#ifdef VIDEORECORDER_SSE2
+// returns the dot product of 4 RGBA pixels
+// with the given coefficients as 4 32-bit integers
+static inline __m128i rgba_dot(__m128i pixels, __m128i coefficients)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    __m128i low  = _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), coefficients);
+    __m128i high = _mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), coefficients);
+
+    __m128 a = _mm_shuffle_ps(_mm_castsi128_ps(low), _mm_castsi128_ps(high), _MM_SHUFFLE(2, 0, 2, 0));
+    __m128 b = _mm_shuffle_ps(_mm_castsi128_ps(low), _mm_castsi128_ps(high), _MM_SHUFFLE(3, 1, 3, 1));
+
+    return _mm_add_epi32(_mm_castps_si128(a), _mm_castps_si128(b));
+}
+
+// converts 8 RGBA pixels to 8 bytes using the given coefficients
+static inline void rgba_convert8(const uint8_t *src, uint8_t *dst, __m128i coefficients, int offset)
+{
+    const __m128i rounding = _mm_set1_epi32(128);
+    const __m128i offsetVec = _mm_set1_epi32(offset);
+
+    __m128i pixels0 = _mm_loadu_si128((const __m128i *)src);
+    __m128i pixels1 = _mm_loadu_si128((const __m128i *)(src + 16));
+
+    __m128i result0 = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(rgba_dot(pixels0, coefficients), rounding), 8), offsetVec);
+    __m128i result1 = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(rgba_dot(pixels1, coefficients), rounding), 8), offsetVec);
+
+    __m128i result = _mm_packus_epi16(_mm_packs_epi32(result0, result1), _mm_setzero_si128());
+    _mm_storel_epi64((__m128i *)dst, result);
+}
+
+// averages 2x4 RGBA pixels (2 rows) into 2 RGBA pixels,
+// stored in the first and third 32-bit lane
+static inline __m128i rgba_average2x4(const uint8_t *row0, const uint8_t *row1)
+{
+    __m128i vertical = _mm_avg_epu8(_mm_loadu_si128((const __m128i *)row0), _mm_loadu_si128((const __m128i *)row1));
+    return _mm_avg_epu8(vertical, _mm_srli_si128(vertical, 4));
+}
+#endif // VIDEORECORDER_SSE2
+
+// converts a bottom-up RGBA image to I420,
+// width and height must be even
+static void rgba_to_i420(const uint8_t *rgba, int stride, int width, int height, uint8_t *yuv)
+{
+    uint8_t *yPlane = yuv;
+    uint8_t *uPlane = yPlane + (width * height);
+    uint8_t *vPlane = uPlane + ((width / 2) * (height / 2));
+
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t *src = rgba + ((height - 1 - y) * stride);
+        uint8_t *dst = yPlane + (y * width);
+        int x = 0;
+
+#ifdef VIDEORECORDER_SSE2
+        const __m128i coefficients = _mm_setr_epi16(Y_R, Y_G, Y_B, 0, Y_R, Y_G, Y_B, 0);
+        for (; x + 8 <= width; x += 8)
+        {
+            rgba_convert8(src + (x * 4), dst + x, coefficients, 16);
+        }
+#endif // VIDEORECORDER_SSE2
+
+        for (; x < width; x++)
+        {
+            dst[x] = rgb_to_y(src[x * 4], src[x * 4 + 1], src[x * 4 + 2]);
+        }
+    }
+
+    for (int y = 0; y < (height / 2); y++)
+    {
+        const uint8_t *row0 = rgba + ((height - 1 - (y * 2)) * stride);
+        const uint8_t *row1 = rgba + ((height - 2 - (y * 2)) * stride);
+        uint8_t *uDst = uPlane + (y * (width / 2));
+        uint8_t *vDst = vPlane + (y * (width / 2));
+        int x = 0;
+
+#ifdef VIDEORECORDER_SSE2
+        const __m128i uCoefficients = _mm_setr_epi16(U_R, U_G, U_B, 0, U_R, U_G, U_B, 0);
+        const __m128i vCoefficients = _mm_setr_epi16(V_R, V_G, V_B, 0, V_R, V_G, V_B, 0);
+        uint8_t averaged[32];
+        for (; x + 16 <= width; x += 16)
+        {
+            // average 2x16 pixels into 8 pixels
+            for (int i = 0; i < 4; i++)
+            {
+                __m128i pair0 = rgba_average2x4(row0 + ((x + (i * 4)) * 4), row1 + ((x + (i * 4)) * 4));
+                __m128i pair1 = _mm_shuffle_epi32(pair0, _MM_SHUFFLE(2, 0, 2, 0));
+                _mm_storel_epi64((__m128i *)(averaged + (i * 8)), pair1);
+            }
+
+            rgba_convert8(averaged, uDst + (x / 2), uCoefficients, 128);
+            rgba_convert8(averaged, vDst + (x / 2), vCoefficients, 128);
+        }
+#endif // VIDEORECORDER_SSE2
+
+        for (; x < width; x += 2)
+        {
+            int r = (row0[x * 4] + row0[x * 4 + 4] + row1[x * 4] + row1[x * 4 + 4] + 2) / 4;
+            int g = (row0[x * 4 + 1] + row0[x * 4 + 5] + row1[x * 4 + 1] + row1[x * 4 + 5] + 2) / 4;
+            int b = (row0[x * 4 + 2] + row0[x * 4 + 6] + row1[x * 4 + 2] + row1[x * 4 + 6] + 2) / 4;
+
+            uDst[x / 2] = rgb_to_u(r, g, b);
+            vDst[x / 2] = rgb_to_v(r, g, b);
+        }
+    }
+}
+
+// resamples 16-bit stereo samples with linear interpolation,
+// position is the fractional input position carried over
+// between calls, so consecutive buffers join up
+static void resample_audio(const int16_t *input, size_t inputFrames, int inputFrequency, int outputFrequency,
+                           double &position, std::vector<uint8_t> &output)
+{
+    double step = (double)inputFrequency / outputFrequency;
+    int16_t samples[2];
+
+    for (; position < inputFrames; position += step)
+    {
+        size_t index = (size_t)position;
+        size_t next = std::min(index + 1, inputFrames - 1);
+        double fraction = position - index;
+
+        for (int channel = 0; channel < 2; channel++)
+        {
+            int first = input[(index * 2) + channel];
+            int second = input[(next * 2) + channel];
+            samples[channel] = (int16_t)(first + ((second - first) * fraction));
+        }
+
+        const uint8_t *data = (const uint8_t *)samples;
+        output.insert(output.end(), data, data + sizeof(samples));
+    }
+
+    position -= inputFrames;
+}
+
+static void write_le16(std::ofstream &stream, uint16_t value)
+{
+    uint8_t data[2] = {(uint8_t)value, (uint8_t)(value >> 8)};
+    stream.write((const char *)data, sizeof(data));
+}
+
+static void write_le32(std::ofstream &stream, uint32_t value)
+{
+    uint8_t data[4] = {(uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+    stream.write((const char *)data, sizeof(data));
+}
+
+//
+// Exported Functions
+//
+
+VideoRecorder::VideoRecorder(void)
+{
+}
+
+VideoRecorder::~VideoRecorder(void)
+{
+    this->Stop();
+}
+
+bool VideoRecorder::Start(std::string file, int frameRate)
+{
+    if (this->recording)
+    {
+        return false;
+    }
+
+    this->videoStream.open(file + ".y4m", std::ios::binary | std::ios::trunc);
+    this->audioStream.open(file + ".wav", std::ios::binary | std::ios::trunc);
+    if (!this->videoStream.is_open() || !this->audioStream.is_open())
+    {
+        this->videoStream.close();
+        this->audioStream.close();
+        return false;
+    }
+
+    this->file = file;
+    this->frameRate = frameRate;
+    this->frameWidth = 0;
+    this->frameHeight = 0;
+    this->outputFrames = 0;
+    this->nextSequence = 0;
+    this->nextWriteSequence = 0;
+    this->droppedFrames = 0;
+    this->audioFrequency = 0;
+    this->audioResamplePosition = 0;
+    this->audioFrames = 0;
+    this->audioStartTime = 0;
+    this->startTime = std::chrono::steady_clock::now();
+    this->audioBytesWritten = 0;
+    this->audioBuffer.clear();
+    this->stopThreads = false;
+
+    // placeholder header, the sizes are
+    // filled in when the recording stops
+    this->audio_WriteHeader();
+
+    this->frames = std::vector<Frame>(FRAME_SLOTS);
+    this->freeFrames.clear();
+    this->convertQueue.clear();
+    this->writeQueue.clear();
+    for (Frame &frame : this->frames)
+    {
+        this->freeFrames.push_back(&frame);
+    }
+
+    for (int i = 0; i < WORKER_THREADS; i++)
+    {
+        this->workerThreads.emplace_back(&VideoRecorder::worker_Thread, this);
+    }
+    this->writerThread = std::thread(&VideoRecorder::writer_Thread, this);
+
+    this->recording = true;
+    return true;
+}
+
+void VideoRecorder::Stop(void)
+{
+    if (!this->recording)
+    {
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->recording = false;
+    }
+
+    {
+        // wait until every queued frame has been written
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->idleCondition.wait(lock, [this] { return this->freeFrames.size() == this->frames.size(); });
+        this->stopThreads = true;
+    }
+
+    this->convertCondition.notify_all();
+    this->writeCondition.notify_all();
+
+    for (std::thread &thread : this->workerThreads)
+    {
+        thread.join();
+    }
+    this->workerThreads.clear();
+    this->writerThread.join();
+
+    // fill in the final sizes
+    this->audioStream.seekp(0);
+    this->audio_WriteHeader();
+
+    this->videoStream.close();
+    this->audioStream.close();
+    this->frames.clear();
+    this->freeFrames.clear();
+}
+
+bool VideoRecorder::IsRecording(void)
+{
+    return this->recording;
+}
+
+double VideoRecorder::GetTime(void)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->get_Time();
+}
+
+bool VideoRecorder::PushFrame(const uint8_t *data, int width, int height, double time)
+{
+    if (width < 2 || height < 2)
+    {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    // check under the lock, this makes sure
+    // Stop() waits for the frame we're queueing
+    if (!this->recording)
+    {
+        return false;
+    }
+
+    // the output frame which should show this frame,
+    // frames which are swapped faster than the frame
+    // rate are skipped, slower ones are repeated
+    uint64_t targetFrames = (uint64_t)(time * this->frameRate) + 1;
+    if (targetFrames <= this->outputFrames)
+    {
+        return false;
+    }
+
+    if (this->frameWidth == 0)
+    {
+        this->frameWidth = width;
+        this->frameHeight = height;
+    }
+
+    // the recording size is fixed,
+    // so drop frames with a different size,
+    // the next frame fills the gap
+    if (this->freeFrames.empty() || width != this->frameWidth || height != this->frameHeight)
+    {
+        this->droppedFrames++;
+        return false;
+    }
+
+    Frame *frame = this->freeFrames.back();
+    this->freeFrames.pop_back();
+
+    frame->width = width;
+    frame->height = height;
+    frame->repeat = (int)(targetFrames - this->outputFrames - 1);
+    frame->sequence = this->nextSequence++;
+    this->outputFrames = targetFrames;
+
+    // only the copy happens on the calling thread,
+    // the conversion happens on the worker threads
+    lock.unlock();
+    frame->rgba.resize((size_t)width * height * 4);
+    std::memcpy(frame->rgba.data(), data, frame->rgba.size());
+    lock.lock();
+
+    this->convertQueue.push_back(frame);
+    lock.unlock();
+
+    this->convertCondition.notify_one();
+    return true;
+}
+
+void VideoRecorder::PushAudio(const void *data, int length, int frequency)
+{
+    if (length <= 0)
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    if (!this->recording)
+    {
+        return;
+    }
+
+    if (this->audioFrequency == 0)
+    {
+        // continue from the wall clock, so
+        // switching clocks doesn't skip frames
+        this->audioFrequency = frequency;
+        this->audioStartTime = this->get_Time();
+    }
+
+    if (this->audioBuffer.size() + length > AUDIO_BUFFER_MAX)
+    {
+        return;
+    }
+
+    size_t previousSize = this->audioBuffer.size();
+
+    // the WAV header has a single frequency, so
+    // samples with a different frequency (i.e after
+    // the game changed the DAC rate) are resampled
+    if (frequency != this->audioFrequency && frequency > 0)
+    {
+        resample_audio((const int16_t *)data, length / 4, frequency, this->audioFrequency,
+                       this->audioResamplePosition, this->audioBuffer);
+    }
+    else
+    {
+        const uint8_t *samples = (const uint8_t *)data;
+        this->audioBuffer.insert(this->audioBuffer.end(), samples, samples + length);
+        this->audioResamplePosition = 0;
+    }
+    this->audioFrames += (this->audioBuffer.size() - previousSize) / 4;
+    lock.unlock();
+
+    this->writeCondition.notify_one();
+}
+
+int VideoRecorder::GetDroppedFrames(void)
+{
+    return this->droppedFrames;
+}
+
+// see GetTime(), the mutex must be locked
+double VideoRecorder::get_Time(void)
+{
+    if (this->audioFrequency != 0)
+    {
+        return this->audioStartTime + ((double)this->audioFrames / this->audioFrequency);
+    }
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - this->startTime).count();
+}
+
+void VideoRecorder::worker_Thread(void)
+{
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    while (true)
+    {
+        this->convertCondition.wait(lock, [this] { return this->stopThreads || !this->convertQueue.empty(); });
+
+        if (this->convertQueue.empty())
+        {
+            return;
+        }
+
+        Frame *frame = this->convertQueue.front();
+        this->convertQueue.erase(this->convertQueue.begin());
+        lock.unlock();
+
+        // I420 requires an even size
+        int width = frame->width & ~1;
+        int height = frame->height & ~1;
+
+        frame->yuv.resize((size_t)width * height * 3 / 2);
+        rgba_to_i420(frame->rgba.data(), frame->width * 4, width, height, frame->yuv.data());
+
+        lock.lock();
+        this->writeQueue[frame->sequence] = frame;
+        this->writeCondition.notify_one();
+    }
+}
+
+void VideoRecorder::writer_Thread(void)
+{
+    std::vector<uint8_t> audio;
+    bool headerWritten = false;
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    while (true)
+    {
+        this->writeCondition.wait(lock, [this] {
+            return this->stopThreads || !this->audioBuffer.empty() ||
+                   this->writeQueue.find(this->nextWriteSequence) != this->writeQueue.end();
+        });
+
+        if (!this->audioBuffer.empty())
+        {
+            audio.swap(this->audioBuffer);
+            lock.unlock();
+
+            this->audioStream.write((const char *)audio.data(), audio.size());
+            this->audioBytesWritten += audio.size();
+            audio.clear();
+
+            lock.lock();
+        }
+
+        auto iter = this->writeQueue.find(this->nextWriteSequence);
+        if (iter != this->writeQueue.end())
+        {
+            Frame *frame = iter->second;
+            this->writeQueue.erase(iter);
+            lock.unlock();
+
+            if (!headerWritten)
+            {
+                this->video_WriteHeader();
+                headerWritten = true;
+            }
+
+            // repeat the frame until the next frame's
+            // timestamp, this keeps the frame rate constant
+            for (int i = 0; i <= frame->repeat; i++)
+            {
+                this->videoStream.write("FRAME\n", 6);
+                this->videoStream.write((const char *)frame->yuv.data(), frame->yuv.size());
+            }
+
+            lock.lock();
+            this->nextWriteSequence++;
+            this->freeFrames.push_back(frame);
+            this->idleCondition.notify_all();
+            continue;
+        }
+
+        if (this->stopThreads && this->audioBuffer.empty())
+        {
+            return;
+        }
+    }
+}
+
+void VideoRecorder::video_WriteHeader(void)
+{
+    std::string header;
+
+    header = "YUV4MPEG2 W" + std::to_string(this->frameWidth & ~1);
+    header += " H" + std::to_string(this->frameHeight & ~1);
+    header += " F" + std::to_string(this->frameRate) + ":1";
+    header += " Ip A1:1 C420jpeg\n";
+
+    this->videoStream.write(header.c_str(), header.size());
+}
+
+void VideoRecorder::audio_WriteHeader(void)
+{
+    const int channels = 2;
+    const int bitsPerSample = 16;
+    int frequency = this->audioFrequency == 0 ? 44100 : this->audioFrequency;
+
+    this->audioStream.write("RIFF", 4);
+    write_le32(this->audioStream, 36 + this->audioBytesWritten);
+    this->audioStream.write("WAVE", 4);
+    this->audioStream.write("fmt ", 4);
+    write_le32(this->audioStream, 16);
+    write_le16(this->audioStream, 1);
+    write_le16(this->audioStream, channels);
+    write_le32(this->audioStream, frequency);
+    write_le32(this->audioStream, frequency * channels * (bitsPerSample / 8));
+    write_le16(this->audioStream, channels * (bitsPerSample / 8));
+    write_le16(this->audioStream, bitsPerSample);
+    this->audioStream.write("data", 4);
+    write_le32(this->audioStream, this->audioBytesWritten);
+}
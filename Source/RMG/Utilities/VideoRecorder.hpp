@@ -0,0 +1,124 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef VIDEORECORDER_HPP
+#define VIDEORECORDER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Utilities
+{
+// records RGBA frames into a YUV4MPEG2 (.y4m) file
+// and 16-bit stereo PCM into a WAV (.wav) file,
+// frames are converted on a fixed pool of worker threads,
+// when all frame slots are in use, frames are dropped
+// instead of blocking the caller, frames are timestamped
+// against the recorded audio (or the wall clock without
+// audio) and repeated or dropped to keep a constant
+// frame rate, so the video stays in sync with the audio
+class VideoRecorder
+{
+  public:
+    VideoRecorder(void);
+    ~VideoRecorder(void);
+
+    // starts recording to '<file>.y4m' and '<file>.wav'
+    bool Start(std::string file, int frameRate);
+
+    // stops recording and waits until
+    // all queued frames have been written
+    void Stop(void);
+
+    bool IsRecording(void);
+
+    // returns the recording time in seconds, the recorded
+    // audio is the clock because it follows the emulation
+    // speed and pauses, without audio the wall clock is used
+    double GetTime(void);
+
+    // queues a bottom-up RGBA frame which was captured at
+    // time (see GetTime()), returns false when the frame was
+    // dropped, the size of the first frame determines the size
+    // of the recording, the frame is shown until the next frame
+    bool PushFrame(const uint8_t *data, int width, int height, double time);
+
+    // queues 16-bit stereo PCM samples, the frequency
+    // of the first samples determines the frequency of
+    // the recording, later samples are resampled to it
+    void PushAudio(const void *data, int length, int frequency);
+
+    int GetDroppedFrames(void);
+
+  private:
+    struct Frame
+    {
+        std::vector<uint8_t> rgba;
+        std::vector<uint8_t> yuv;
+        int width = 0;
+        int height = 0;
+        int repeat = 0;
+        uint64_t sequence = 0;
+    };
+
+    std::atomic<bool> recording = false;
+    std::atomic<int> droppedFrames = 0;
+
+    std::mutex mutex;
+    std::condition_variable convertCondition;
+    std::condition_variable writeCondition;
+    std::condition_variable idleCondition;
+
+    std::vector<Frame> frames;
+    std::vector<Frame *> freeFrames;
+    std::vector<Frame *> convertQueue;
+    std::map<uint64_t, Frame *> writeQueue;
+
+    std::vector<std::thread> workerThreads;
+    std::thread writerThread;
+    bool stopThreads = false;
+
+    int frameWidth = 0;
+    int frameHeight = 0;
+    int frameRate = 60;
+    uint64_t outputFrames = 0;
+    uint64_t nextSequence = 0;
+    uint64_t nextWriteSequence = 0;
+
+    std::vector<uint8_t> audioBuffer;
+    int audioFrequency = 0;
+    double audioResamplePosition = 0;
+    uint64_t audioFrames = 0;
+    double audioStartTime = 0;
+    std::chrono::steady_clock::time_point startTime;
+    uint32_t audioBytesWritten = 0;
+
+    std::string file;
+    std::ofstream videoStream;
+    std::ofstream audioStream;
+
+    double get_Time(void);
+
+    void worker_Thread(void);
+    void writer_Thread(void);
+
+    void video_WriteHeader(void);
+    void audio_WriteHeader(void);
+};
+} // namespace Utilities
+
+#endif // VIDEORECORDER_HPP
@@ -8,15 +8,67 @@
  *  along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
 #include "VidExt.hpp"
+#include "Utilities/VideoRecorder.hpp"
+#include "Thread/PresentThread.hpp"
 
 #include <RMG-Core/VidExt.hpp>
+#include <RMG-Core/Plugins.hpp>
+#include <RMG-Core/Error.hpp>
+#include <RMG-Core/Settings/Settings.hpp>
 #include <RMG-Core/m64p/Api.hpp>
 
 #include <QApplication>
+#include <QOpenGLBuffer>
 #include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLFunctions>
 #include <QThread>
 #include <QScreen>
 
+#include <algorithm>
+#include <atomic>
+
+//
+// Local Defines
+//
+
+// render targets are allocated in multiples
+// of this size, so resizing the window only
+// re-allocates them when the size class changes
+#define PRESENT_SIZE_CLASS 256
+
+// amount of pixel buffers used for the
+// asynchronous framebuffer readback,
+// a frame is mapped when the buffer is
+// reused, so (RECORDING_BUFFERS - 1) frames later
+#define RECORDING_BUFFERS 3
+// frame rate of the recording, frames are
+// repeated or dropped to keep it constant
+#define RECORDING_FRAMERATE 60
+
+//
+// Local Structures
+//
+
+struct l_PresentSlot
+{
+    GLuint Texture = 0;
+    GLuint Framebuffer = 0;
+    // allocated size of the texture
+    int TextureWidth = 0;
+    int TextureHeight = 0;
+};
+
+struct l_RecordingBuffer
+{
+    QOpenGLBuffer Buffer = QOpenGLBuffer(QOpenGLBuffer::PixelPackBuffer);
+    int Width = 0;
+    int Height = 0;
+    // recording time when the frame was read back
+    double Time = 0;
+    bool Pending = false;
+};
+
 //
 // Local Variables
 //
@@ -24,10 +76,444 @@
 static Thread::EmulationThread* l_EmuThread          = nullptr;
 static UserInterface::MainWindow* l_MainWindow       = nullptr;
 static UserInterface::Widget::OGLWidget* l_OGLWidget = nullptr;
+static UserInterface::Widget::VKWidget* l_VKWidget   = nullptr;
+static VidExtRenderMode l_RenderMode                 = VidExtRenderMode::OpenGL;
 static QThread* l_RenderThread                       = nullptr;
 static bool l_VidExtSetup                            = false;
+// the size the window has been resized to last,
+// so it doesn't have to be read from the emulation thread
+static std::atomic<QSize> l_WindowSize;
 static QSurfaceFormat l_SurfaceFormat;
 
+static Thread::PresentThread* l_PresentThread        = nullptr;
+static QOpenGLContext* l_RenderContext               = nullptr;
+static bool l_ThreadedPresent                        = false;
+static GLuint l_RenderFramebuffer                    = 0;
+static GLuint l_RenderTexture                        = 0;
+static GLuint l_RenderDepthStencil                   = 0;
+static int l_RenderWidth                             = 0;
+static int l_RenderHeight                            = 0;
+static int l_RenderTextureWidth                      = 0;
+static int l_RenderTextureHeight                     = 0;
+static l_PresentSlot l_PresentSlots[PRESENT_SLOTS];
+
+static Utilities::VideoRecorder l_VideoRecorder;
+static l_RecordingBuffer l_RecordingBuffers[RECORDING_BUFFERS];
+static int l_RecordingBufferIndex                    = 0;
+static bool l_RecordingBuffersCreated                = false;
+
+//
+// Local Functions
+//
+
+static QOpenGLContext* get_render_context(void)
+{
+    if (l_ThreadedPresent)
+    {
+        return l_RenderContext;
+    }
+
+    return l_OGLWidget->context();
+}
+
+static GLuint get_default_framebuffer(void)
+{
+    if (l_ThreadedPresent)
+    {
+        return l_RenderFramebuffer;
+    }
+
+    return l_OGLWidget->context()->defaultFramebufferObject();
+}
+
+// returns size rounded up to its size class
+static int present_size_class(int size)
+{
+    return std::max(1, (size + PRESENT_SIZE_CLASS - 1) / PRESENT_SIZE_CLASS) * PRESENT_SIZE_CLASS;
+}
+
+// resizes the framebuffer the video plugin renders into,
+// it renders into the bottom left corner of the storage,
+// which is only re-allocated when the size class changes
+static void present_resize_framebuffer(int width, int height)
+{
+    QOpenGLExtraFunctions* functions = l_RenderContext->extraFunctions();
+    int textureWidth = present_size_class(width);
+    int textureHeight = present_size_class(height);
+    GLint previousTexture = 0;
+    GLint previousRenderbuffer = 0;
+    GLint previousFramebuffer = 0;
+    GLint previousUnpackBuffer = 0;
+
+    l_RenderWidth = width;
+    l_RenderHeight = height;
+
+    if (l_RenderFramebuffer != 0 &&
+        textureWidth == l_RenderTextureWidth &&
+        textureHeight == l_RenderTextureHeight)
+    {
+        return;
+    }
+
+    if (l_RenderFramebuffer == 0)
+    {
+        functions->glGenFramebuffers(1, &l_RenderFramebuffer);
+        functions->glGenTextures(1, &l_RenderTexture);
+        functions->glGenRenderbuffers(1, &l_RenderDepthStencil);
+    }
+
+    // the video plugin may cache its state,
+    // so restore everything we change
+    functions->glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+    functions->glGetIntegerv(GL_RENDERBUFFER_BINDING, &previousRenderbuffer);
+    functions->glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    functions->glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &previousUnpackBuffer);
+    functions->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    // keep the same framebuffer object,
+    // only re-allocate its storage
+    functions->glBindTexture(GL_TEXTURE_2D, l_RenderTexture);
+    functions->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, textureWidth, textureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    functions->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    functions->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    functions->glBindRenderbuffer(GL_RENDERBUFFER, l_RenderDepthStencil);
+    functions->glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, textureWidth, textureHeight);
+
+    functions->glBindFramebuffer(GL_FRAMEBUFFER, l_RenderFramebuffer);
+    functions->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, l_RenderTexture, 0);
+    functions->glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, l_RenderDepthStencil);
+    functions->glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, l_RenderDepthStencil);
+
+    functions->glBindTexture(GL_TEXTURE_2D, previousTexture);
+    functions->glBindRenderbuffer(GL_RENDERBUFFER, previousRenderbuffer);
+    functions->glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+    functions->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, previousUnpackBuffer);
+
+    l_RenderTextureWidth = textureWidth;
+    l_RenderTextureHeight = textureHeight;
+}
+
+static bool present_setup(void)
+{
+    QOpenGLContext* windowContext = l_OGLWidget->context();
+    QSurfaceFormat format;
+    bool supported;
+
+    // create a context which shares its objects
+    // with the window context, the video plugin
+    // renders into a framebuffer object on it
+    l_RenderContext = new QOpenGLContext();
+    l_RenderContext->setFormat(windowContext->format());
+    l_RenderContext->setShareContext(windowContext);
+
+    if (!l_RenderContext->create() ||
+        !l_RenderContext->makeCurrent(l_OGLWidget->GetOffscreenSurface()))
+    {
+        delete l_RenderContext;
+        l_RenderContext = nullptr;
+        return false;
+    }
+
+    // fences and framebuffer blits are required
+    format = l_RenderContext->format();
+    if (l_RenderContext->isOpenGLES())
+    {
+        supported = format.majorVersion() >= 3;
+    }
+    else
+    {
+        supported = format.version() >= qMakePair(3, 2) ||
+                    (l_RenderContext->hasExtension("GL_ARB_sync") &&
+                     l_RenderContext->hasExtension("GL_ARB_framebuffer_object"));
+    }
+
+    if (!supported)
+    {
+        l_RenderContext->doneCurrent();
+        delete l_RenderContext;
+        l_RenderContext = nullptr;
+        return false;
+    }
+
+    QSize size = l_OGLWidget->GetFramebufferSize();
+    present_resize_framebuffer(size.width(), size.height());
+
+    // hand the window context over to the present thread
+    windowContext->moveToThread(l_PresentThread);
+    l_PresentThread->SetSurface(windowContext, l_OGLWidget);
+    l_PresentThread->start();
+    return true;
+}
+
+static void present_frame(void)
+{
+    QOpenGLExtraFunctions* functions = l_RenderContext->extraFunctions();
+    QSize size = l_OGLWidget->GetFramebufferSize();
+    int width = size.width();
+    int height = size.height();
+    GLint previousTexture = 0;
+    GLint previousReadFramebuffer = 0;
+    GLint previousDrawFramebuffer = 0;
+    GLint previousUnpackBuffer = 0;
+    GLboolean scissorTest;
+    GLsync readFence;
+    GLsync renderFence;
+    int slotIndex;
+
+    slotIndex = l_PresentThread->AcquireSlot(&readFence);
+    l_PresentSlot* slot = &l_PresentSlots[slotIndex];
+
+    // wait until the present thread
+    // is done reading from the texture
+    if (readFence != 0)
+    {
+        functions->glWaitSync(readFence, 0, GL_TIMEOUT_IGNORED);
+        functions->glDeleteSync(readFence);
+    }
+
+    // the video plugin may cache its state,
+    // so restore everything we change
+    functions->glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+    functions->glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousReadFramebuffer);
+    functions->glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousDrawFramebuffer);
+    scissorTest = functions->glIsEnabled(GL_SCISSOR_TEST);
+
+    if (slot->Texture == 0)
+    {
+        functions->glGenTextures(1, &slot->Texture);
+        functions->glGenFramebuffers(1, &slot->Framebuffer);
+    }
+
+    // slots use the size class of the framebuffer too
+    if (slot->TextureWidth != l_RenderTextureWidth || slot->TextureHeight != l_RenderTextureHeight)
+    {
+        functions->glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &previousUnpackBuffer);
+        functions->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        functions->glBindTexture(GL_TEXTURE_2D, slot->Texture);
+        functions->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, l_RenderTextureWidth, l_RenderTextureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        functions->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        functions->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        functions->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, slot->Framebuffer);
+        functions->glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, slot->Texture, 0);
+
+        functions->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, previousUnpackBuffer);
+
+        slot->TextureWidth = l_RenderTextureWidth;
+        slot->TextureHeight = l_RenderTextureHeight;
+    }
+
+    // copy the frame into the texture of the slot
+    if (scissorTest)
+    {
+        functions->glDisable(GL_SCISSOR_TEST);
+    }
+    functions->glBindFramebuffer(GL_READ_FRAMEBUFFER, l_RenderFramebuffer);
+    functions->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, slot->Framebuffer);
+    functions->glBlitFramebuffer(0, 0, l_RenderWidth, l_RenderHeight,
+                                 0, 0, l_RenderWidth, l_RenderHeight,
+                                 GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    if (scissorTest)
+    {
+        functions->glEnable(GL_SCISSOR_TEST);
+    }
+
+    renderFence = functions->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    functions->glFlush();
+
+    functions->glBindTexture(GL_TEXTURE_2D, previousTexture);
+    functions->glBindFramebuffer(GL_READ_FRAMEBUFFER, previousReadFramebuffer);
+    functions->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previousDrawFramebuffer);
+
+    // only the rendered part of the texture is presented
+    l_PresentThread->Present(slotIndex, slot->Texture, l_RenderWidth, l_RenderHeight, renderFence);
+
+    // follow the size of the window,
+    // like the default framebuffer would
+    if (width != l_RenderWidth || height != l_RenderHeight)
+    {
+        present_resize_framebuffer(width, height);
+    }
+}
+
+static void present_destroy(void)
+{
+    QOpenGLExtraFunctions* functions = l_RenderContext->extraFunctions();
+
+    // the window context is moved back to this thread
+    l_PresentThread->Stop(QThread::currentThread());
+
+    for (l_PresentSlot& slot : l_PresentSlots)
+    {
+        if (slot.Texture != 0)
+        {
+            functions->glDeleteTextures(1, &slot.Texture);
+            functions->glDeleteFramebuffers(1, &slot.Framebuffer);
+        }
+
+        slot = l_PresentSlot();
+    }
+
+    functions->glDeleteFramebuffers(1, &l_RenderFramebuffer);
+    functions->glDeleteTextures(1, &l_RenderTexture);
+    functions->glDeleteRenderbuffers(1, &l_RenderDepthStencil);
+    l_RenderFramebuffer = 0;
+    l_RenderTexture = 0;
+    l_RenderDepthStencil = 0;
+    l_RenderWidth = 0;
+    l_RenderHeight = 0;
+    l_RenderTextureWidth = 0;
+    l_RenderTextureHeight = 0;
+
+    l_RenderContext->doneCurrent();
+    delete l_RenderContext;
+    l_RenderContext = nullptr;
+    l_ThreadedPresent = false;
+}
+
+static void recording_destroy_buffers(void)
+{
+    for (l_RecordingBuffer& buffer : l_RecordingBuffers)
+    {
+        if (buffer.Buffer.isCreated())
+        {
+            buffer.Buffer.destroy();
+        }
+
+        buffer.Width = 0;
+        buffer.Height = 0;
+        buffer.Pending = false;
+    }
+
+    l_RecordingBufferIndex = 0;
+    l_RecordingBuffersCreated = false;
+}
+
+static void recording_readback(void)
+{
+    if (!l_VideoRecorder.IsRecording())
+    {
+        if (l_RecordingBuffersCreated)
+        {
+            recording_destroy_buffers();
+        }
+        return;
+    }
+
+    QOpenGLContext* context = get_render_context();
+    QOpenGLFunctions* functions = context->functions();
+    QSize size = l_OGLWidget->GetFramebufferSize();
+    int width = size.width();
+    int height = size.height();
+    GLint previousFramebuffer = 0;
+
+    l_RecordingBuffer* current = &l_RecordingBuffers[l_RecordingBufferIndex];
+
+    if (!current->Buffer.isCreated())
+    {
+        current->Buffer.create();
+        current->Buffer.setUsagePattern(QOpenGLBuffer::StreamRead);
+        l_RecordingBuffersCreated = true;
+    }
+
+    // queue the readback of the current frame,
+    // glReadPixels() into a bound pixel buffer
+    // returns without waiting for the GPU
+    functions->glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    functions->glBindFramebuffer(GL_FRAMEBUFFER, get_default_framebuffer());
+
+    current->Buffer.bind();
+    if (current->Width != width || current->Height != height)
+    {
+        current->Buffer.allocate(width * height * 4);
+        current->Width = width;
+        current->Height = height;
+    }
+    current->Time = l_VideoRecorder.GetTime();
+    functions->glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    current->Buffer.release();
+    current->Pending = true;
+
+    functions->glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+
+    // map the oldest buffer, its readback
+    // has had a few frames to complete
+    l_RecordingBufferIndex = (l_RecordingBufferIndex + 1) % RECORDING_BUFFERS;
+    l_RecordingBuffer* oldest = &l_RecordingBuffers[l_RecordingBufferIndex];
+
+    if (!oldest->Pending)
+    {
+        return;
+    }
+
+    oldest->Buffer.bind();
+    const uint8_t* data = (const uint8_t*)oldest->Buffer.map(QOpenGLBuffer::ReadOnly);
+    if (data != nullptr)
+    {
+        l_VideoRecorder.PushFrame(data, oldest->Width, oldest->Height, oldest->Time);
+        oldest->Buffer.unmap();
+    }
+    oldest->Buffer.release();
+    oldest->Pending = false;
+}
+
+static void recording_audio_callback(const void* data, int length, int frequency)
+{
+    l_VideoRecorder.PushAudio(data, length, frequency);
+}
+
+static QWindow* get_render_window(void)
+{
+    if (l_RenderMode == VidExtRenderMode::Vulkan)
+    {
+        return l_VKWidget;
+    }
+
+    return l_OGLWidget;
+}
+
+// returns the screen which is used for output,
+// has to be called on the GUI thread
+static QScreen* get_output_screen(void)
+{
+    QScreen* screen = VidExtGetFullscreenScreen();
+    if (screen != nullptr)
+    {
+        return screen;
+    }
+
+    screen = get_render_window()->screen();
+    if (screen != nullptr)
+    {
+        return screen;
+    }
+
+    return QApplication::primaryScreen();
+}
+
+static QSize get_screen_size(QScreen* screen)
+{
+    // account for HiDPI scaling
+    return screen->size() * screen->devicePixelRatio();
+}
+
+// retrieves the modes of the screens, Qt's screens
+// can only be used on the GUI thread, so they're
+// collected there when called from another thread
+static void get_screen_modes(QList<QSize>& sizes, QList<int>& rates)
+{
+    if (QThread::currentThread() == QApplication::instance()->thread())
+    {
+        VidExtGetScreenModes(sizes, rates);
+    }
+    else
+    {
+        l_EmuThread->on_VidExt_ListScreenModes(&sizes, &rates);
+    }
+}
+
 //
 // VidExt Functions
 //
@@ -41,13 +527,45 @@ static void VidExt_OglSetup(void)
         continue;
     }
 
-    l_OGLWidget->makeCurrent();
+    // fall back to presenting on this
+    // thread when it can't be set up
+    l_ThreadedPresent = CoreSettingsGetBoolValue(SettingsID::GUI_ThreadedPresent) &&
+                        present_setup();
+    if (!l_ThreadedPresent)
+    {
+        l_OGLWidget->makeCurrent();
+    }
+
     l_VidExtSetup = true;
 }
 
-static m64p_error VidExt_Init(void)
+static void VidExt_Setup(void)
 {
+    if (l_RenderMode == VidExtRenderMode::OpenGL)
+    {
+        VidExt_OglSetup();
+    }
+    else
+    {
+        // the video plugin creates the surface
+        // using VidExt_VKGetSurface(), the native
+        // window is created on the GUI thread
+        l_EmuThread->on_VidExt_SetupVK();
+        l_VidExtSetup = true;
+    }
+}
+
+static m64p_error VidExt_InitWithRenderMode(m64p_render_mode RenderMode)
+{
+#if !QT_CONFIG(vulkan)
+    if (RenderMode == M64P_RENDER_VULKAN)
+    {
+        return M64ERR_UNSUPPORTED;
+    }
+#endif // !QT_CONFIG(vulkan)
+
     l_RenderThread = QThread::currentThread();
+    l_RenderMode = (RenderMode == M64P_RENDER_VULKAN) ? VidExtRenderMode::Vulkan : VidExtRenderMode::OpenGL;
 
     l_SurfaceFormat = QSurfaceFormat::defaultFormat();
     l_SurfaceFormat.setOption(QSurfaceFormat::DeprecatedFunctions, 1);
@@ -57,14 +575,29 @@ static m64p_error VidExt_Init(void)
     l_SurfaceFormat.setMinorVersion(1);
     l_SurfaceFormat.setSwapInterval(0);
 
-    l_EmuThread->on_VidExt_Init();
+    l_WindowSize = QSize();
+    l_EmuThread->on_VidExt_Init(l_RenderMode);
 
     return M64ERR_SUCCESS;
 }
 
+static m64p_error VidExt_Init(void)
+{
+    return VidExt_InitWithRenderMode(M64P_RENDER_OPENGL);
+}
+
 static m64p_error VidExt_Quit(void)
 {
-    l_OGLWidget->MoveToThread(QApplication::instance()->thread());
+    if (l_RenderMode == VidExtRenderMode::OpenGL)
+    {
+        recording_destroy_buffers();
+        if (l_ThreadedPresent)
+        {
+            present_destroy();
+        }
+        l_OGLWidget->MoveToThread(QApplication::instance()->thread());
+    }
+
     l_EmuThread->on_VidExt_Quit();
     l_VidExtSetup = false;
 
@@ -73,18 +606,82 @@ static m64p_error VidExt_Quit(void)
 
 static m64p_error VidExt_ListModes(m64p_2d_size *SizeArray, int *NumSizes)
 {
-    QSize size = QApplication::primaryScreen()->size();
-    SizeArray[0].uiHeight = size.height();
-    SizeArray[0].uiWidth = size.width();
-    *NumSizes = 1;
+    QList<QSize> screenSizes;
+    QList<int> screenRates;
+    QList<QSize> sizes;
+    int maxSizes = *NumSizes;
+
+    get_screen_modes(screenSizes, screenRates);
+
+    // Qt only exposes the current mode of each screen,
+    // so list the output screen first, followed by
+    // the (unique) sizes of the other screens
+    for (const QSize& size : screenSizes)
+    {
+        if (!sizes.contains(size))
+        {
+            sizes.append(size);
+        }
+    }
+
+    *NumSizes = 0;
+    for (const QSize& size : sizes)
+    {
+        if (*NumSizes >= maxSizes)
+        {
+            break;
+        }
+
+        SizeArray[*NumSizes].uiWidth = size.width();
+        SizeArray[*NumSizes].uiHeight = size.height();
+        (*NumSizes)++;
+    }
 
     return M64ERR_SUCCESS;
 }
 
 static m64p_error VidExt_ListRates(m64p_2d_size Size, int *NumRates, int *Rates)
 {
-    Rates[0] = QApplication::primaryScreen()->refreshRate();
-    *NumRates = 1;
+    QList<QSize> screenSizes;
+    QList<int> screenRates;
+    QList<int> rates;
+    int maxRates = *NumRates;
+
+    get_screen_modes(screenSizes, screenRates);
+
+    // the output screen comes first,
+    // so its rate is preferred
+    for (int i = 0; i < screenSizes.size(); i++)
+    {
+        const QSize& size = screenSizes.at(i);
+        int rate = screenRates.at(i);
+
+        if (size.width() == (int)Size.uiWidth &&
+            size.height() == (int)Size.uiHeight &&
+            !rates.contains(rate))
+        {
+            rates.append(rate);
+        }
+    }
+
+    // no screen has the given size,
+    // so the output screen will scale it
+    if (rates.isEmpty() && !screenRates.isEmpty())
+    {
+        rates.append(screenRates.first());
+    }
+
+    *NumRates = 0;
+    for (int rate : rates)
+    {
+        if (*NumRates >= maxRates)
+        {
+            break;
+        }
+
+        Rates[*NumRates] = rate;
+        (*NumRates)++;
+    }
 
     return M64ERR_SUCCESS;
 }
@@ -93,9 +690,10 @@ static m64p_error VidExt_SetMode(int Width, int Height, int BitsPerPixel, int Sc
 {
     if (!l_VidExtSetup)
     {
-        VidExt_OglSetup();
+        VidExt_Setup();
     }
 
+    l_WindowSize = QSize(Width, Height);
     l_EmuThread->on_VidExt_SetMode(Width, Height, BitsPerPixel, ScreenMode, Flags);
     return M64ERR_SUCCESS;
 }
@@ -104,7 +702,7 @@ static m64p_error VidExt_SetModeWithRate(int Width, int Height, int RefreshRate,
 {
     if (!l_VidExtSetup)
     {
-        VidExt_OglSetup();
+        VidExt_Setup();
     }
 
     switch (ScreenMode)
@@ -112,9 +710,11 @@ static m64p_error VidExt_SetModeWithRate(int Width, int Height, int RefreshRate,
         case M64VIDEO_NONE:
             return M64ERR_INPUT_INVALID;
         case M64VIDEO_WINDOWED:
+            l_WindowSize = QSize(Width, Height);
             l_EmuThread->on_VidExt_SetWindowedModeWithRate(Width, Height, RefreshRate, BitsPerPixel, Flags);
             break;
         case M64VIDEO_FULLSCREEN:
+            l_WindowSize = QSize(Width, Height);
             l_EmuThread->on_VidExt_SetFullscreenModeWithRate(Width, Height, RefreshRate, BitsPerPixel, Flags);
             break;
     }
@@ -124,7 +724,7 @@ static m64p_error VidExt_SetModeWithRate(int Width, int Height, int RefreshRate,
 
 static m64p_function VidExt_GLGetProc(const char *Proc)
 {
-    return l_OGLWidget->context()->getProcAddress(Proc);
+    return get_render_context()->getProcAddress(Proc);
 }
 
 static m64p_error VidExt_GLSetAttr(m64p_GLattr Attr, int Value)
@@ -258,6 +858,14 @@ static m64p_error VidExt_GLSwapBuf(void)
         return M64ERR_UNSUPPORTED;
     }
 
+    recording_readback();
+
+    if (l_ThreadedPresent)
+    {
+        present_frame();
+        return M64ERR_SUCCESS;
+    }
+
     l_OGLWidget->context()->swapBuffers(l_OGLWidget);
     l_OGLWidget->context()->makeCurrent(l_OGLWidget);
 
@@ -279,6 +887,9 @@ static m64p_error VidExt_ToggleFS(void)
         return M64ERR_SYSTEM_FAIL;
     }
 
+    // the window size changes afterwards
+    l_WindowSize = QSize();
+
     if (QThread::currentThread() != l_RenderThread)
     {
         l_MainWindow->on_VidExt_ToggleFS((videoMode == M64VIDEO_WINDOWED));
@@ -293,28 +904,114 @@ static m64p_error VidExt_ToggleFS(void)
 
 static m64p_error VidExt_ResizeWindow(int Width, int Height)
 {
+    QSize size(Width, Height);
+
+    // skip the round trip to the GUI thread
+    // when the window already has the requested size
+    if (l_WindowSize.exchange(size) == size)
+    {
+        return M64ERR_SUCCESS;
+    }
+
     l_EmuThread->on_VidExt_ResizeWindow(Width, Height);
     return M64ERR_SUCCESS;
 }
 
 static uint32_t VidExt_GLGetDefaultFramebuffer(void)
 {
-    return l_OGLWidget->context()->defaultFramebufferObject();
+    return get_default_framebuffer();
+}
+
+static m64p_error VidExt_VKGetSurface(void** Surface, void* Instance)
+{
+#if QT_CONFIG(vulkan)
+    VkSurfaceKHR surface;
+
+    if (l_RenderMode != VidExtRenderMode::Vulkan)
+    {
+        return M64ERR_INVALID_STATE;
+    }
+
+    if (!l_VidExtSetup)
+    {
+        VidExt_Setup();
+    }
+
+    // the surface is owned by the video plugin,
+    // which destroys it with its instance
+    surface = l_VKWidget->CreateSurface((VkInstance)Instance);
+    if (surface == VK_NULL_HANDLE)
+    {
+        return M64ERR_SYSTEM_FAIL;
+    }
+
+    *(VkSurfaceKHR*)Surface = surface;
+    return M64ERR_SUCCESS;
+#else
+    return M64ERR_UNSUPPORTED;
+#endif // QT_CONFIG(vulkan)
+}
+
+static m64p_error VidExt_VKGetInstanceExtensions(const char** Extensions[], uint32_t* NumExtensions)
+{
+#if QT_CONFIG(vulkan)
+    // the video plugin creates the instance,
+    // so it has to enable the surface extensions
+    // required by the current windowing system
+    static const char* xcbExtensions[]     = { "VK_KHR_surface", "VK_KHR_xcb_surface" };
+    static const char* waylandExtensions[] = { "VK_KHR_surface", "VK_KHR_wayland_surface" };
+    static const char* win32Extensions[]   = { "VK_KHR_surface", "VK_KHR_win32_surface" };
+    static const char* macosExtensions[]   = { "VK_KHR_surface", "VK_MVK_macos_surface" };
+
+    QString platform = QApplication::platformName();
+
+    if (platform == "xcb")
+    {
+        *Extensions = xcbExtensions;
+    }
+    else if (platform.startsWith("wayland"))
+    {
+        *Extensions = waylandExtensions;
+    }
+    else if (platform == "windows")
+    {
+        *Extensions = win32Extensions;
+    }
+    else if (platform == "cocoa")
+    {
+        *Extensions = macosExtensions;
+    }
+    else
+    {
+        return M64ERR_UNSUPPORTED;
+    }
+
+    *NumExtensions = 2;
+    return M64ERR_SUCCESS;
+#else
+    return M64ERR_UNSUPPORTED;
+#endif // QT_CONFIG(vulkan)
 }
 
 //
 // Exported Functions
 //
 
-bool SetupVidExt(Thread::EmulationThread* emuThread, UserInterface::MainWindow* mainWindow, UserInterface::Widget::OGLWidget* oglWidget)
+bool SetupVidExt(Thread::EmulationThread* emuThread, UserInterface::MainWindow* mainWindow, UserInterface::Widget::OGLWidget* oglWidget, UserInterface::Widget::VKWidget* vkWidget)
 {
     l_EmuThread = emuThread;
     l_MainWindow = mainWindow;
     l_OGLWidget = oglWidget;
+    l_VKWidget = vkWidget;
+
+    if (l_PresentThread == nullptr)
+    {
+        l_PresentThread = new Thread::PresentThread(mainWindow);
+    }
 
     m64p_video_extension_functions vidext_funcs;
 
-    vidext_funcs.Functions = 14;
+    vidext_funcs.Functions = 17;
     vidext_funcs.VidExtFuncInit = &VidExt_Init;
     vidext_funcs.VidExtFuncQuit = &VidExt_Quit;
     vidext_funcs.VidExtFuncListModes = &VidExt_ListModes;
@@ -329,8 +1026,89 @@ bool SetupVidExt(Thread::EmulationThread* emuThread, UserInterface::MainWindow*
     vidext_funcs.VidExtFuncToggleFS = &VidExt_ToggleFS;
     vidext_funcs.VidExtFuncResizeWindow = &VidExt_ResizeWindow;
     vidext_funcs.VidExtFuncGLGetDefaultFramebuffer = &VidExt_GLGetDefaultFramebuffer;
+    vidext_funcs.VidExtFuncInitWithRenderMode = &VidExt_InitWithRenderMode;
+    vidext_funcs.VidExtFuncVKGetSurface = &VidExt_VKGetSurface;
+    vidext_funcs.VidExtFuncVKGetInstanceExtensions = &VidExt_VKGetInstanceExtensions;
 
     return CoreSetupVidExt(vidext_funcs);
 }
 
+bool VidExtStartRecording(QString file)
+{
+    std::string error;
+
+    if (l_VidExtSetup && l_RenderMode == VidExtRenderMode::Vulkan)
+    {
+        error = "VidExtStartRecording Failed: ";
+        error += "recording isn't supported with Vulkan video plugins!";
+        CoreSetError(error);
+        return false;
+    }
+
+    if (!l_VideoRecorder.Start(file.toStdString(), RECORDING_FRAMERATE))
+    {
+        error = "VidExtStartRecording Failed: ";
+        error += "failed to open recording files!";
+        CoreSetError(error);
+        return false;
+    }
+
+    // audio is optional, so a plugin
+    // without capture support is fine
+    CorePluginsSetAudioCaptureCallback(&recording_audio_callback);
+    return true;
+}
+
+void VidExtStopRecording(void)
+{
+    CorePluginsSetAudioCaptureCallback(nullptr);
+    l_VideoRecorder.Stop();
+}
+
+bool VidExtIsRecording(void)
+{
+    return l_VideoRecorder.IsRecording();
+}
 
+void VidExtSetWindowSize(int width, int height)
+{
+    l_WindowSize = QSize(width, height);
+}
+
+void VidExtGetScreenModes(QList<QSize>& sizes, QList<int>& rates)
+{
+    QList<QScreen*> screens = QApplication::screens();
+    QScreen* outputScreen = get_output_screen();
+
+    sizes.clear();
+    rates.clear();
+
+    // the output screen comes first
+    screens.removeAll(outputScreen);
+    screens.prepend(outputScreen);
+
+    for (QScreen* screen : screens)
+    {
+        sizes.append(get_screen_size(screen));
+        rates.append(qRound(screen->refreshRate()));
+    }
+}
+
+QScreen* VidExtGetFullscreenScreen(void)
+{
+    QString screenName = QString::fromStdString(CoreSettingsGetStringValue(SettingsID::GUI_FullscreenScreen));
+    if (screenName.isEmpty())
+    {
+        return nullptr;
+    }
+
+    for (QScreen* screen : QApplication::screens())
+    {
+        if (screen->name() == screenName)
+        {
+            return screen;
+        }
+    }
+
+    return nullptr;
+}
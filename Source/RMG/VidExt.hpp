@@ -11,9 +11,36 @@
 #define RMG_VIDEXT_HPP
 
 #include <UserInterface/Widget/OGLWidget.hpp>
+#include <UserInterface/Widget/VKWidget.hpp>
 #include <UserInterface/MainWindow.hpp>
 #include <Thread/EmulationThread.hpp>
 
-bool SetupVidExt(Thread::EmulationThread* emuThread, UserInterface::MainWindow* mainWindow, UserInterface::Widget::OGLWidget* oglWidget);
+#include <QScreen>
+
+bool SetupVidExt(Thread::EmulationThread* emuThread, UserInterface::MainWindow* mainWindow, UserInterface::Widget::OGLWidget* oglWidget, UserInterface::Widget::VKWidget* vkWidget);
+
+// starts recording the emulation output
+// to '<file>.y4m' and '<file>.wav'
+bool VidExtStartRecording(QString file);
+
+// stops recording
+void VidExtStopRecording(void);
+
+// returns whether recording is active
+bool VidExtIsRecording(void);
+
+// stores the size the window has been resized
+// to by the user, in the video plugin's pixels
+void VidExtSetWindowSize(int width, int height);
+
+// returns the screen chosen for fullscreen,
+// or nullptr when no (connected) screen was chosen,
+// has to be called on the GUI thread
+QScreen* VidExtGetFullscreenScreen(void);
+
+// retrieves the size in pixels and the refresh rate
+// of each screen, the output screen comes first,
+// has to be called on the GUI thread
+void VidExtGetScreenModes(QList<QSize>& sizes, QList<int>& rates);
 
 #endif // RMG_VIDEXT_HPP
\ No newline at end of file
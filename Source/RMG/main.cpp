@@ -8,6 +8,7 @@
  *  along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
 #include <UserInterface/MainWindow.hpp>
+#include <RMG-Core/Core.hpp>
 
 #include <QApplication>
 #include <QDir>
@@ -28,6 +29,8 @@ int main(int argc, char **argv)
 
     window.show();
 
+    CoreTrace("main: window shown");
+
     // try to find an argument
     // with a file that exists,
     // if such an argument exists,